@@ -0,0 +1,227 @@
+/*********************************************************************************
+created:	2026/10/22   03:30PM
+filename: 	benchmark_face_detectors.cpp
+file base:	benchmark_face_detectors
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	Program that compares the speed and the recall of the face detector
+backends (Haar, LBP and HOG), to pick the cheapest one that finds enough faces.
+Usage: benchmark_face_detectors images [haar file] [lbp file] [hog file] [width]
+images is either a text file with one "image_file x y width height" face per line
+(an image can have several lines), or the image of one face that is pasted at
+random sizes and positions in synthetic frames. The frames are downscaled to
+width pixels (320 by default) as in fvkFaceDetector. A backend that cannot be
+loaded is skipped.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFaceDetectorBackend.h>
+#include <fvk/camera/fvkFaceDetector.h>
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <algorithm>
+#include <cstdlib>
+
+using namespace R3D;
+
+// one image with the rectangles of its faces.
+struct Sample
+{
+	cv::Mat gray;
+	std::vector<cv::Rect> faces;
+};
+
+// samples from a text file with one "image_file x y width height" face per line.
+static auto loadAnnotations(const std::string& _filename) -> std::vector<Sample>
+{
+	std::map<std::string, std::vector<cv::Rect>> faces;
+	std::ifstream in(_filename);
+	std::string line;
+	while (std::getline(in, line))
+	{
+		std::istringstream ss(line);
+		std::string file;
+		cv::Rect r;
+		if (ss >> file >> r.x >> r.y >> r.width >> r.height)
+			faces[file].push_back(r);
+	}
+
+	std::vector<Sample> samples;
+	for (const auto& f : faces)
+	{
+		Sample s;
+		s.gray = cv::imread(f.first, cv::IMREAD_GRAYSCALE);
+		if (s.gray.empty())
+		{
+			std::cout << "could not read " << f.first << "\n";
+			continue;
+		}
+		s.faces = f.second;
+		samples.push_back(s);
+	}
+	return samples;
+}
+
+// synthetic frames with the face pasted at a random size and position on a noisy gradient.
+static auto makeSamples(const cv::Mat& _face, int _count) -> std::vector<Sample>
+{
+	cv::RNG rng(12345);
+	std::vector<Sample> samples;
+	for (auto i = 0; i < _count; i++)
+	{
+		Sample s;
+		s.gray.create(480, 640, CV_8UC1);
+		const auto a = rng.uniform(40, 200);
+		for (auto y = 0; y < s.gray.rows; y++)
+		{
+			auto p = s.gray.ptr<uchar>(y);
+			for (auto x = 0; x < s.gray.cols; x++)
+				p[x] = cv::saturate_cast<uchar>(a + (x + y) * 40 / (s.gray.cols + s.gray.rows));
+		}
+
+		// faces from 1/5th to 1/2 of the frame height, as searched by fvkFaceDetector.
+		const auto h = rng.uniform(s.gray.rows / 5, s.gray.rows / 2);
+		const auto w = h * _face.cols / _face.rows;
+		const cv::Rect r(rng.uniform(0, s.gray.cols - w), rng.uniform(0, s.gray.rows - h), w, h);
+		cv::resize(_face, s.gray(r), r.size(), 0, 0, cv::INTER_AREA);
+
+		cv::Mat noise(s.gray.size(), CV_16SC1);
+		cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(6));
+		cv::add(s.gray, noise, s.gray, cv::noArray(), CV_8UC1);
+
+		s.faces.push_back(r);
+		samples.push_back(s);
+	}
+	return samples;
+}
+
+// intersection over union of two rectangles.
+static auto overlap(const cv::Rect& _a, const cv::Rect& _b) -> double
+{
+	const auto i = (_a & _b).area();
+	const auto u = _a.area() + _b.area() - i;
+	return u > 0 ? static_cast<double>(i) / static_cast<double>(u) : 0.0;
+}
+
+static void benchmark(fvkFaceDetectorBackend& _backend, const std::vector<Sample>& _samples, int _width)
+{
+	std::vector<cv::Rect> found;
+	cv::Mat small;
+	auto faces = 0;
+	auto hits = 0;
+	auto falses = 0;
+	auto ms = 0.0;
+
+	for (const auto& s : _samples)
+	{
+		auto scale = fvkFaceDetector::downscale(s.gray, small, _width);
+		if (scale <= 0)
+		{
+			small = s.gray;
+			scale = 1;
+		}
+
+		// the same range of sizes as fvkFaceDetector::detectFaceAllSizes.
+		const auto t = cv::getTickCount();
+		_backend.detect(small, found, cv::Size(small.rows / 5, small.rows / 5), cv::Size(small.rows * 2 / 3, small.rows * 2 / 3));
+		ms += static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency();
+
+		// a face is found if a detection overlaps it by 30% (the boxes of the models differ).
+		std::vector<bool> used(found.size(), false);
+		for (const auto& f : s.faces)
+		{
+			const cv::Rect r(cvRound(f.x * scale), cvRound(f.y * scale), cvRound(f.width * scale), cvRound(f.height * scale));
+			faces++;
+			for (std::size_t i = 0; i < found.size(); i++)
+			{
+				if (!used[i] && overlap(found[i], r) > 0.3)
+				{
+					used[i] = true;
+					hits++;
+					break;
+				}
+			}
+		}
+		falses += static_cast<int>(std::count(used.begin(), used.end(), false));
+	}
+
+	const auto n = static_cast<double>(_samples.size());
+	std::cout << std::left << std::setw(8) << fvkFaceDetectorBackend::name(_backend.type()) << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(12) << ms / n
+		<< std::setw(14) << (ms > 0 ? n * 1000.0 / ms : 0.0)
+		<< std::setw(10) << (faces > 0 ? 100.0 * hits / faces : 0.0) << "%"
+		<< std::setw(12) << falses / n << "\n";
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: benchmark_face_detectors images [haar file] [lbp file] [hog file] [width]\n";
+		return 1;
+	}
+
+	const std::string images = argv[1];
+	std::vector<Sample> samples;
+	if (images.size() > 4 && images.substr(images.size() - 4) == ".txt")
+	{
+		samples = loadAnnotations(images);
+	}
+	else
+	{
+		const auto face = cv::imread(images, cv::IMREAD_GRAYSCALE);
+		if (!face.empty())
+			samples = makeSamples(face, 200);
+	}
+	if (samples.empty())
+	{
+		std::cout << "no image in " << images << "\n";
+		return 1;
+	}
+
+	const std::string files[] = {
+		argc > 2 ? argv[2] : "haarcascade_frontalface_default.xml",
+		argc > 3 ? argv[3] : "lbpcascade_frontalface_improved.xml",
+		argc > 4 ? argv[4] : "hog_face.yml"
+	};
+	const fvkFaceDetectorBackend::Type types[] = {
+		fvkFaceDetectorBackend::Type::Haar,
+		fvkFaceDetectorBackend::Type::Lbp,
+		fvkFaceDetectorBackend::Type::Hog
+	};
+	const auto width = argc > 5 ? std::max(1, std::atoi(argv[5])) : 320;
+
+	std::cout << "images: " << samples.size() << ", width: " << width << "\n\n";
+	std::cout << std::left << std::setw(8) << "backend" << std::right
+		<< std::setw(12) << "ms/image" << std::setw(14) << "images/sec"
+		<< std::setw(11) << "recall" << std::setw(12) << "false/image" << "\n";
+
+	for (auto i = 0; i < 3; i++)
+	{
+		auto b = fvkFaceDetectorBackend::create(types[i]);
+		if (!b->load(files[i]))
+		{
+			std::cout << std::left << std::setw(8) << fvkFaceDetectorBackend::name(types[i]) << "could not load " << files[i] << "\n";
+			continue;
+		}
+		benchmark(*b, samples, width);
+	}
+
+	return 0;
+}
@@ -0,0 +1,235 @@
+/*********************************************************************************
+created:	2026/10/19   11:05AM
+filename: 	benchmark_filters.cpp
+file base:	benchmark_filters
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	Program that compares the cost and the error of the fast filter modes
+against the exact OpenCV filters.
+Usage: benchmark_filters [image file] [iterations]
+If no image is specified, a synthetic 1280x720 frame is used.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkImageProcessing.h>
+#include <fvk/camera/fvkGeometricTransform.h>
+#include <fvk/camera/fvkPipeline.h>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace R3D;
+
+// synthetic frame with smooth gradients, hard edges and sensor-like noise.
+static cv::Mat makeTestImage(const cv::Size& _size)
+{
+	cv::Mat img(_size, CV_8UC3);
+	for (auto y = 0; y < img.rows; y++)
+	{
+		auto p = img.ptr<cv::Vec3b>(y);
+		for (auto x = 0; x < img.cols; x++)
+			p[x] = cv::Vec3b(static_cast<uchar>(x * 255 / img.cols), static_cast<uchar>(y * 255 / img.rows), static_cast<uchar>(128));
+	}
+	cv::rectangle(img, cv::Rect(img.cols / 8, img.rows / 8, img.cols / 4, img.rows / 4), cv::Scalar(20, 200, 240), -1);
+	cv::circle(img, cv::Point(img.cols * 2 / 3, img.rows / 2), img.rows / 4, cv::Scalar(230, 40, 60), -1);
+
+	cv::Mat noise(_size, CV_16SC3);
+	cv::randn(noise, cv::Scalar::all(0), cv::Scalar::all(12));
+	cv::Mat out;
+	cv::add(img, noise, out, cv::noArray(), CV_8UC3);
+	return out;
+}
+
+// average time in milliseconds of the given function.
+template <typename F>
+static auto timeIt(F _f, int _iterations) -> double
+{
+	_f();	// warm up (allocations, caches).
+	const auto t = cv::getTickCount();
+	for (auto i = 0; i < _iterations; i++)
+		_f();
+	return static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency() / _iterations;
+}
+
+static void report(const std::string& _name, double _exact_ms, double _fast_ms, const cv::Mat& _exact, const cv::Mat& _fast)
+{
+	const auto mae = cv::norm(_exact, _fast, cv::NORM_L1) / static_cast<double>(_exact.total() * _exact.channels());
+	const auto maxe = cv::norm(_exact, _fast, cv::NORM_INF);
+	std::cout << std::left << std::setw(28) << _name << std::right << std::fixed << std::setprecision(2)
+		<< std::setw(10) << _exact_ms << std::setw(10) << _fast_ms
+		<< std::setw(9) << (_fast_ms > 0 ? _exact_ms / _fast_ms : 0.0) << "x"
+		<< std::setw(10) << mae << std::setw(8) << maxe << "\n";
+}
+
+static void benchmarkDenoising(const cv::Mat& _img, int _iterations)
+{
+	const std::vector<int> levels = { 7, 15, 25 };
+	for (auto method : { fvkImageProcessing::DenoisingMethod::Median, fvkImageProcessing::DenoisingMethod::Bilateral })
+	{
+		for (auto level : levels)
+		{
+			cv::Mat exact, fast;
+			const auto te = timeIt([&]() { exact = _img.clone(); fvkImageProcessing::setDenoisingFilter(exact, level, method, fvkImageProcessing::FilterQuality::Exact); }, _iterations);
+			const auto tf = timeIt([&]() { fast = _img.clone(); fvkImageProcessing::setDenoisingFilter(fast, level, method, fvkImageProcessing::FilterQuality::Fast); }, _iterations);
+			const auto name = std::string(method == fvkImageProcessing::DenoisingMethod::Median ? "median " : "bilateral ") + std::to_string(level);
+			report(name, te, tf, exact, fast);
+		}
+	}
+}
+
+static void benchmarkSharpening(const cv::Mat& _img, int _iterations)
+{
+	// exact reference is the OpenCV gaussian followed by the weighted sum, as setWeightedFilter did before.
+	for (auto sigma : { 4, 8, 16, 32 })
+	{
+		cv::Mat exact, fast;
+		const auto te = timeIt([&]()
+		{
+			cv::Mat m;
+			cv::GaussianBlur(_img, m, cv::Size(0, 0), static_cast<double>(sigma));
+			cv::addWeighted(_img, 1.5, m, -0.5, 0, exact);
+		}, _iterations);
+		const auto tf = timeIt([&]() { fast = _img.clone(); fvkImageProcessing::setWeightedFilter(fast, sigma, 1.5, -0.5); }, _iterations);
+		report("sharpen " + std::to_string(sigma), te, tf, exact, fast);
+	}
+}
+
+static void benchmarkNonPhotorealistic(const cv::Mat& _img, int _iterations)
+{
+	// same parameters as fvkImageProcessing::imageProcessing.
+	struct Npr { const char* name; fvkImageProcessing::Filters filter; int value; float sigma; };
+	const Npr filters[] = {
+		{ "smoothness 60", fvkImageProcessing::Filters::Smoothing, 60, 0.1f },
+		{ "details 10", fvkImageProcessing::Filters::Details, 10, 0.02f },
+		{ "pencil sketch 10", fvkImageProcessing::Filters::PencilSketch, 10, 0.1f },
+		{ "stylization 60", fvkImageProcessing::Filters::Stylization, 60, 0.45f }
+	};
+	for (const auto& f : filters)
+	{
+		cv::Mat exact, fast;
+		const auto te = timeIt([&]() { exact = _img.clone(); fvkImageProcessing::setNonPhotorealisticFilter(exact, f.value, f.sigma, f.filter, fvkImageProcessing::FilterQuality::Exact); }, _iterations);
+		const auto tf = timeIt([&]() { fast = _img.clone(); fvkImageProcessing::setNonPhotorealisticFilter(fast, f.value, f.sigma, f.filter, fvkImageProcessing::FilterQuality::Fast); }, _iterations);
+		report(f.name, te, tf, exact, fast);
+	}
+}
+
+static void benchmarkGeometry(const cv::Mat& _img, int _iterations)
+{
+	// exact reference is the former chain of resize, flip and transpose/flip passes.
+	const auto zoomed = cv::Size(_img.cols * 3 / 2, _img.rows * 3 / 2);
+	fvkGeometricTransform g;
+	for (auto angle : { 0.0, 90.0 })
+	{
+		cv::Mat exact, fast;
+		const auto te = timeIt([&]()
+		{
+			cv::Mat m;
+			cv::resize(_img, m, zoomed, 0, 0, cv::INTER_LINEAR);
+			cv::flip(m, m, 1);
+			if (angle == 90.0)
+			{
+				cv::transpose(m, m);
+				cv::flip(m, m, 0);
+			}
+			exact = m;
+		}, _iterations);
+		const auto tf = timeIt([&]() { g.apply(_img, fast, zoomed, false, true, angle); }, _iterations);
+		report("zoom+flip+rotate " + std::to_string(static_cast<int>(angle)), te, tf, exact, fast);
+	}
+}
+
+static void benchmarkPipeline(const cv::Mat& _img, int _iterations)
+{
+	// the same chain with the configurable image processing and with a fixed pipeline.
+	fvkImageProcessing ip;
+	ip.setFlipDirection(fvkImageProcessing::FlipDirection::Horizontal);
+	ip.setEqualizeClipLimit(2.0);
+	ip.setSharpeningLevel(5);
+	ip.setBrightness(10);
+	ip.setContrast(10);
+	ip.setSepia(50);
+
+	using namespace fvkStages;
+	fvkPipeline<Flip, Equalize, Sharpen, Brightness, Contrast, Sepia> p(
+		Flip(fvkImageProcessing::FlipDirection::Horizontal), Equalize(2.0), Sharpen(5), Brightness(10), Contrast(10), Sepia(50));
+
+	cv::Mat exact, fast;
+	const auto te = timeIt([&]() { exact = _img.clone(); ip.imageProcessing(exact); }, _iterations);
+	const auto tf = timeIt([&]() { fast = _img.clone(); p.process(fast); }, _iterations);
+	report("pipeline", te, tf, exact, fast);
+}
+
+static void benchmarkFixedPoint(const cv::Mat& _img, int _iterations)
+{
+	// exact reference is the former floating-point implementation of every filter.
+	using Filter = void(*)(cv::Mat&, int);
+	struct Point { const char* name; Filter reference; Filter fast; int value; };
+	const Point filters[] = {
+		{ "color contrast 40", fvkImageProcessing::setColorContrastFilterReference, fvkImageProcessing::setColorContrastFilter, 40 },
+		{ "exposure 30", fvkImageProcessing::setExposureFilterReference, fvkImageProcessing::setExposureFilter, 30 },
+		{ "sepia 50", fvkImageProcessing::setSepiaFilterReference, fvkImageProcessing::setSepiaFilter, 50 }
+	};
+	for (const auto& f : filters)
+	{
+		cv::Mat exact, fast;
+		const auto te = timeIt([&]() { exact = _img.clone(); f.reference(exact, f.value); }, _iterations);
+		const auto tf = timeIt([&]() { fast = _img.clone(); f.fast(fast, f.value); }, _iterations);
+		report(f.name, te, tf, exact, fast);
+	}
+}
+
+static void benchmarkEmboss(const cv::Mat& _img, int _iterations)
+{
+	// exact reference is the former negative pass followed by cv::filter2D with a char kernel.
+	for (auto negative : { false, true })
+	{
+		cv::Mat exact, fast;
+		const auto te = timeIt([&]()
+		{
+			cv::Mat m = _img;
+			if (negative)
+				cv::bitwise_not(_img, m);
+			cv::Mat kern = (cv::Mat_<char>(3, 3) << -1, -1, 0, -1, 0, 1, 0, 1, 1);
+			cv::filter2D(m, exact, m.depth(), kern, cv::Point(-1, -1), 128);
+		}, _iterations);
+		const auto tf = timeIt([&]() { fast = _img.clone(); fvkImageProcessing::setEmbossFilter(fast, negative); }, _iterations);
+		report(negative ? "negative+emboss" : "emboss", te, tf, exact, fast);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	cv::Mat img;
+	if (argc > 1)
+		img = cv::imread(argv[1], cv::IMREAD_COLOR);
+	if (img.empty())
+		img = makeTestImage(cv::Size(1280, 720));
+
+	const auto iterations = argc > 2 ? std::max(1, std::atoi(argv[2])) : 5;
+
+	std::cout << "frame: " << img.cols << "x" << img.rows << ", iterations: " << iterations << "\n\n";
+	std::cout << std::left << std::setw(28) << "filter" << std::right
+		<< std::setw(10) << "exact ms" << std::setw(10) << "fast ms"
+		<< std::setw(10) << "speedup" << std::setw(10) << "mean err" << std::setw(8) << "max" << "\n";
+
+	benchmarkDenoising(img, iterations);
+	benchmarkSharpening(img, iterations);
+	benchmarkNonPhotorealistic(img, iterations);
+	benchmarkGeometry(img, iterations);
+	benchmarkPipeline(img, iterations);
+	benchmarkFixedPoint(img, iterations);
+	benchmarkEmboss(img, iterations);
+
+	return 0;
+}
@@ -0,0 +1,85 @@
+/*********************************************************************************
+created:	2026/10/21   10:15AM
+filename: 	offline_processing.cpp
+file base:	offline_processing
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	Program that reprocesses a video file with all the cores and reports
+the frames per second and the time of every stage.
+Usage: offline_processing input_file [output_file] [workers]
+If no output file is specified, the processed frames are not encoded.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkOfflineProcessor.h>
+
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+using namespace R3D;
+
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		std::cout << "usage: offline_processing input_file [output_file] [workers]\n";
+		return 1;
+	}
+
+	// the settings that would be given to a camera.
+	fvkImageProcessing ip;
+	ip.setDenoisingLevel(5);
+	ip.setSharpeningLevel(5);
+	ip.setContrast(10);
+	ip.setSepia(30);
+
+	fvkOfflineProcessor p;
+	if (argc > 3)
+		p.setWorkers(std::atoi(argv[3]));
+	p.setProgressFunction([](long long _frames, long long _total)
+	{
+		if (_frames % 100 == 0)
+			std::cout << _frames << " / " << _total << " frames\r" << std::flush;
+	});
+
+	if (!p.process(argv[1], argc > 2 ? argv[2] : "", ip))
+	{
+		std::cout << "could not process " << argv[1] << "\n";
+		return 1;
+	}
+
+	const auto s = p.getStats();
+	if (s.failed > 0)
+		std::cout << s.failed << " frames could not be filtered and were written unfiltered\n";
+	std::cout << std::fixed << std::setprecision(2)
+		<< s.frames << " frames in " << s.seconds << " s with " << s.workers << " workers: " << s.fps << " fps\n\n"
+		<< std::left << std::setw(16) << "stage" << std::right << std::setw(10) << "ms/frame" << "\n"
+		<< std::left << std::setw(16) << "decode" << std::right << std::setw(10) << s.decode << "\n";
+
+	// same order as fvkImageProcessing::Stage.
+	const char* names[] = {
+		"geometry", "face detection", "denoising", "smoothness", "equalize", "sharpening", "details",
+		"pencil sketch", "stylization", "brightness", "contrast", "color contrast", "saturation",
+		"vibrance", "hue", "exposure", "gamma", "sepia", "clip", "negative", "emboss", "dots", "convert color"
+	};
+	for (std::size_t i = 0; i < s.stages.size() && i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		if (s.stages[i] >= 0.005)
+			std::cout << std::left << std::setw(16) << names[i] << std::right << std::setw(10) << s.stages[i] << "\n";
+	}
+	std::cout << std::left << std::setw(16) << "encode" << std::right << std::setw(10) << s.encode << "\n";
+	std::cout << std::left << std::setw(16) << "encode wait" << std::right << std::setw(10) << s.blocked << "\n";
+
+	return 0;
+}
@@ -0,0 +1,160 @@
+#pragma once
+#ifndef fvkAsyncFaceDetector_h__
+#define fvkAsyncFaceDetector_h__
+
+/*********************************************************************************
+created:	2026/10/21   02:40PM
+filename: 	fvkAsyncFaceDetector.h
+file base:	fvkAsyncFaceDetector
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that runs the face detector on its own thread, so the cascade
+does not stall the processing of the frames. The frames are downscaled by the
+caller and handed over without blocking (only the latest one is kept), and the
+results come back tagged with the sequence number of their frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkFaceDetector.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+
+namespace R3D
+{
+
+class fvkFaceDetectionService;
+
+class FVK_CAMERA_EXPORT fvkFaceResult
+{
+public:
+	fvkFaceResult() :
+		seq(0),
+		found(false),
+		duration(0)
+	{
+	}
+	cv::Rect rect;				// face rectangle in the coordinates of the submitted frame.
+	cv::Size frame_size;		// size of the submitted frame.
+	unsigned long long seq;		// sequence number of the frame the face was detected in.
+	bool found;					// true if a face is tracked.
+	double duration;			// time of the detection in milliseconds.
+};
+
+class FVK_CAMERA_EXPORT fvkAsyncFaceDetector
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkAsyncFaceDetector();
+	// Description:
+	// Destructor that stops the detection thread.
+	~fvkAsyncFaceDetector();
+
+	// Description:
+	// Function to load a classifier from a file.
+	// It returns true on success.
+	auto loadCascadeClassifier(const std::string& _filename) -> bool;
+	// Description:
+	// Function to load the model of the given backend from a file.
+	// It returns true on success.
+	auto loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool;
+	// Description:
+	// Function to set the width of the frames given to the detector (see fvkFaceDetector::setResizedWidth).
+	// Default value is 320.
+	void setResizedWidth(int _width);
+	// Description:
+	// Function to get the width of the frames given to the detector.
+	auto getResizedWidth() const -> int;
+	// Description:
+	// Function to turn ON/OFF the linear extrapolation of the face position to the requested
+	// frame, from the last two results.
+	// Default value is true.
+	void setExtrapolation(bool _value);
+	// Description:
+	// Function that returns true if the extrapolation is enabled.
+	auto isExtrapolation() const -> bool;
+
+	// Description:
+	// Function to give a frame to the detector. It never blocks: the frame is downscaled and
+	// replaces the frame that is waiting, if the detector is still busy with an older frame.
+	// _seq is the sequence number of the frame, which must increase with every frame.
+	// The detection thread is started with the first frame.
+	void submit(const cv::Mat& _frame, unsigned long long _seq);
+	// Description:
+	// Overloaded function that takes the downscaled copy from the pyramid of the frame.
+	void submit(fvkFramePyramid& _pyramid, unsigned long long _seq);
+	// Description:
+	// Function to get the latest result.
+	auto getResult() const -> fvkFaceResult;
+	// Description:
+	// Function to get the face rectangle for the frame _seq, which is the latest result moved
+	// along its last motion when the extrapolation is enabled.
+	// It returns an empty rectangle if no face is tracked.
+	auto getRect(unsigned long long _seq) const -> cv::Rect;
+
+	// Description:
+	// Function to run the detection on a service shared with other cameras instead of the
+	// thread of this object, which is stopped (nullptr to use it again).
+	// The service must outlive this object or be removed first.
+	void setService(fvkFaceDetectionService* _service);
+	// Description:
+	// Function to get the service the detection runs on (nullptr if none).
+	auto getService() const -> fvkFaceDetectionService*;
+	// Description:
+	// Function to set the priority of the requests of this object in the service (higher first).
+	// Default value is 0.
+	void setServicePriority(int _priority);
+	// Description:
+	// Function to get the priority of the requests of this object in the service.
+	auto getServicePriority() const -> int;
+
+	// Description:
+	// Function that forgets the tracked face and the waiting frame.
+	void reset();
+	// Description:
+	// Function that stops the detection thread (it is started again by submit).
+	void stop();
+
+private:
+	void run();
+	void result(const fvkFaceResult& _result);
+
+	fvkFaceDetector m_fd;					// used by the detection thread only.
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond;
+	bool m_stop;
+
+	cv::Mat m_pending;						// downscaled frame waiting for the detector.
+	double m_pending_scale;
+	cv::Size m_pending_size;
+	unsigned long long m_pending_seq;
+	bool m_has_pending;
+	bool m_reset;
+
+	fvkFaceResult m_last;					// latest result.
+	fvkFaceResult m_previous;				// result before the latest one.
+	int m_width;
+	bool m_extrapolate;
+
+	fvkFaceDetectionService* m_service;
+	int m_client;							// identifier of this object in m_service.
+	int m_priority;
+};
+
+}
+
+#endif // fvkAsyncFaceDetector_h__
@@ -218,9 +218,17 @@ public:
 	// It is a helper shortcut function to "cam->getCameraProcessingThread()->writer()".
 	auto& writer() { return p_pt->writer(); }
 	// Description:
+	// Function to get a reference to the pre-event recorder.
+	// It is a helper shortcut function to "cam->getCameraProcessingThread()->preEventRecorder()".
+	auto& preEventRecorder() { return p_pt->preEventRecorder(); }
+	// Description:
 	// Function to get a reference to image processing.
 	// It is a helper shortcut function to "cam->getCameraProcessingThread()->imageProcessing()".
 	auto& imageProcessing() { return p_pt->imageProcessing(); }
+	// Description:
+	// Function to get a reference to the quality governor.
+	// It is a helper shortcut function to "cam->getCameraProcessingThread()->governor()".
+	auto& governor() { return p_pt->governor(); }
 
 	// Description:
 	// Function to get a pointer to camera/capturing thread.
@@ -24,6 +24,7 @@ find features.
 **********************************************************************************/
 
 #include "fvkCameraExport.h"
+#include "fvkFaceDetectionService.h"
 
 #include <opencv2/opencv.hpp>
 
@@ -40,7 +41,8 @@ class FVK_CAMERA_EXPORT fvkCameraList
 public:
 	// Description:
 	// Default constructor to create a list of camera objects.
-	fvkCameraList()
+	fvkCameraList() :
+		m_shared(false)
 	{
 	}
 	// Description:
@@ -75,6 +77,8 @@ public:
 		if (it == m_list.end())
 		{
 			m_list.push_back(_cam);
+			if (m_shared)
+				share(_cam);
 			return true;
 		}
 
@@ -209,8 +213,36 @@ public:
 	// Function to a reference to this list.
 	auto& getList() { return m_list; }
 
+	// Description:
+	// Function to get a reference to the face detection service that the cameras can share.
+	// Its model, workers and budget should be set before the sharing is turned ON.
+	auto& getFaceDetectionService() { return m_faces; }
+	// Description:
+	// Function to turn ON/OFF the sharing of the face detection service by all the cameras
+	// of the list, including the ones added later. When it is OFF, every camera runs its own
+	// detector. Only the asynchronous face detection uses the service
+	// (see fvkImageProcessing::setAsyncFaceDetectionEnabled).
+	// Default value is false.
+	void setSharedFaceDetection(bool _value)
+	{
+		m_shared = _value;
+		for (auto cam : m_list)
+			share(cam);
+	}
+	// Description:
+	// Function that returns true if the cameras share the face detection service.
+	auto isSharedFaceDetection() const { return m_shared; }
+
 private:
+	void share(CAMERA* _cam)
+	{
+		if (_cam && _cam->getProcThread())
+			_cam->getProcThread()->imageProcessing().getAsyncFaceDetector().setService(m_shared ? &m_faces : nullptr);
+	}
+
+	fvkFaceDetectionService m_faces;
 	std::vector<CAMERA*> m_list;
+	bool m_shared;
 };
 
 }
@@ -0,0 +1,127 @@
+#pragma once
+#ifndef fvkDetectionSchedule_h__
+#define fvkDetectionSchedule_h__
+
+/*********************************************************************************
+created:	2026/10/22   10:05AM
+filename: 	fvkDetectionSchedule.h
+file base:	fvkDetectionSchedule
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that decides on which frames the face detection runs.
+The detection runs at once on a scene change or when the face is lost, and
+its interval doubles (up to a maximum) while the face and the scene are stable.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+#include "fvkFramePyramid.h"
+
+#include <opencv2/core.hpp>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkDetectionScheduleStats
+{
+public:
+	fvkDetectionScheduleStats() :
+		frames(0),
+		detections(0),
+		detections_per_second(0),
+		saving(0),
+		interval(0),
+		difference(0)
+	{
+	}
+	long long frames;				// number of frames.
+	long long detections;			// number of detections.
+	double detections_per_second;	// average number of detections per second.
+	double saving;					// fraction of the detections of the fixed schedule that were saved (0 to 1).
+	int interval;					// current number of frames between two detections.
+	double difference;				// mean absolute difference of the last frame with the previous one (0 to 255).
+};
+
+class FVK_CAMERA_EXPORT fvkDetectionSchedule
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkDetectionSchedule();
+
+	// Description:
+	// Function to turn ON/OFF the adaptive schedule.
+	// When it is OFF, the detection runs on a fixed number of frames.
+	// Default value is true.
+	void setAdaptive(bool _value);
+	// Description:
+	// Function that returns true if the schedule is adaptive.
+	auto isAdaptive() const -> bool;
+	// Description:
+	// Function to set the maximum number of frames between two detections.
+	// The minimum is the frame delay given to next().
+	// Default value is 60.
+	void setMaxInterval(int _frames);
+	// Description:
+	// Function to get the maximum number of frames between two detections.
+	auto getMaxInterval() const -> int;
+	// Description:
+	// Function to set the thresholds of the mean absolute difference between two frames (0 to 255).
+	// Below _stable the scene is stable and the interval can grow; above _scene the scene has
+	// changed and the detection runs at once.
+	// Default values are 2 and 20.
+	void setThresholds(double _stable, double _scene);
+
+	// Description:
+	// Function to be called with every frame. It returns true if the detection must run on it.
+	// _frame_delay is the number of frames skipped between two detections of the fixed schedule,
+	// which is the minimum of the adaptive one.
+	auto next(const cv::Mat& _frame, int _frame_delay) -> bool;
+	// Description:
+	// Overloaded function that takes the thumbnail from the pyramid of the frame, which is the
+	// same as the one of fvkMotionGate.
+	auto next(fvkFramePyramid& _pyramid, int _frame_delay) -> bool;
+	// Description:
+	// Function to give the result of a detection: _found is true if a face is tracked,
+	// and _face is its rectangle.
+	void detected(bool _found, const cv::Rect& _face);
+
+	// Description:
+	// Function to get the number of detections and the saving.
+	auto getStats() const -> fvkDetectionScheduleStats;
+	// Description:
+	// Function to restart the schedule and the stats.
+	void reset();
+
+private:
+	bool m_adaptive;
+	int m_max;
+	double m_stable;
+	double m_scene;
+
+	cv::Mat m_thumb;			// thumbnail of the current frame.
+	cv::Mat m_prev;				// thumbnail of the previous frame.
+	int m_period;				// adaptive number of frames between two detections (0 = minimum).
+	int m_base;					// number of frames between two detections of the fixed schedule.
+	int m_count;				// frames since the last detection.
+	bool m_immediate;			// the next frame is detected at once.
+	bool m_found;
+	cv::Rect m_face;
+	double m_fixed;				// number of detections of the fixed schedule.
+	int64 m_start;
+	fvkDetectionScheduleStats m_stats;
+};
+
+}
+
+#endif // fvkDetectionSchedule_h__
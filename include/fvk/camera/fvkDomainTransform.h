@@ -0,0 +1,99 @@
+#pragma once
+#ifndef fvkDomainTransform_h__
+#define fvkDomainTransform_h__
+
+/*********************************************************************************
+created:	2026/10/19   02:40PM
+filename: 	fvkDomainTransform.h
+file base:	fvkDomainTransform
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that implements the non-photorealistic filters (edge preserving
+smoothing, detail enhancement, pencil sketch and stylization) on top of the
+domain transform recursive filter (Gastal and Oliveira, 2011).
+It keeps its working buffers between calls, and the passes are parallel
+over rows (horizontal) and over column stripes (vertical).
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkDomainTransform
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkDomainTransform();
+
+	// Description:
+	// Function to set the number of iterations of the recursive filter.
+	// Default value is 3.
+	void setIterations(int _value) { m_iterations = _value < 1 ? 1 : _value; }
+	// Description:
+	// Function to get the number of iterations of the recursive filter.
+	auto getIterations() const { return m_iterations; }
+
+	// Description:
+	// Edge preserving smoothing, equivalent to cv::edgePreservingFilter with cv::RECURS_FILTER.
+	// _sigma_s is the spatial sigma (0 to 200) and _sigma_r is the range sigma (0 to 1).
+	// All functions accept 8-bit images with 1, 3 or 4 channels, and the alpha channel
+	// of a 4 channel image is copied unchanged. They return false for other images.
+	auto edgePreservingFilter(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r) -> bool;
+	// Description:
+	// Detail enhancement, equivalent to cv::detailEnhance.
+	// Only the luma is filtered and its detail layer is added back to every channel.
+	auto detailEnhance(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r) -> bool;
+	// Description:
+	// Color pencil sketch, like the color output of cv::pencilSketch.
+	// The strokes are the gradients of the filtered luma and _shade_factor
+	// (0 to 0.1) scales their darkness.
+	auto pencilSketch(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r, float _shade_factor) -> bool;
+	// Description:
+	// Stylization (watercolor-like), like cv::stylization.
+	// The edge preserving smoothing is darkened by its normalized gradient magnitude.
+	auto stylization(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r) -> bool;
+
+private:
+	// Description:
+	// Computes the integer horizontal and vertical derivatives (sum of the absolute
+	// channel differences) of the 8-bit guide image.
+	void computeDerivatives(const cv::Mat& _guide);
+	// Description:
+	// Loads the color channels of _src (or its luma if _luma is true) into the float working image.
+	void load(const cv::Mat& _src, bool _luma);
+	// Description:
+	// Runs the recursive filter on the working image.
+	// _unit converts the integer derivatives to the normalized intensity units of _sigma_r.
+	void recursiveFilter(float _sigma_s, float _sigma_r, float _unit);
+	// Description:
+	// Computes the gradient magnitude of the working image into m_mag and returns its maximum.
+	auto gradientMagnitude() -> float;
+
+	cv::Mat m_work;		// float working image with the filtered channels.
+	cv::Mat m_luma;		// 8-bit luma of the source (detail enhancement and pencil sketch).
+	cv::Mat m_dx;		// 16-bit horizontal derivatives.
+	cv::Mat m_dy;		// 16-bit vertical derivatives.
+	cv::Mat m_mag;		// float gradient magnitude.
+	std::vector<float> m_lut;	// feedback coefficient for every integer derivative.
+	int m_iterations;
+};
+
+}
+
+#endif // fvkDomainTransform_h__
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef fvkEqualizer_h__
+#define fvkEqualizer_h__
+
+/*********************************************************************************
+created:	2026/10/19   05:20PM
+filename: 	fvkEqualizer.h
+file base:	fvkEqualizer
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class for the adaptive histogram equalization (CLAHE) of the luma
+of a frame. The CLAHE object, with its tile histograms and lookup tables,
+and the luma buffers are kept between the frames.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/imgproc.hpp>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkEqualizer
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkEqualizer();
+
+	// Description:
+	// Function that equalizes the luma of the given 8-bit image. The result is a new
+	// image assigned to _img, so the pixels of the frame shared with others are not changed.
+	// Gray images are equalized directly. For color images the luma (the Y of YCrCb)
+	// is computed in one pass, equalized, and its change is added to the color
+	// channels in a second pass, which leaves the chroma and the alpha channel untouched.
+	// The CLAHE object is only recreated when _cliplimit or _tile_grid_size changes.
+	// It returns false if the image type is not supported.
+	auto apply(cv::Mat& _img, double _cliplimit, const cv::Size& _tile_grid_size = cv::Size(8, 8)) -> bool;
+
+private:
+	cv::Ptr<cv::CLAHE> m_clahe;
+	double m_cliplimit;
+	cv::Size m_tiles;
+	cv::Mat m_luma;		// luma of the current frame.
+	cv::Mat m_eqluma;	// equalized luma.
+};
+
+}
+
+#endif // fvkEqualizer_h__
@@ -0,0 +1,196 @@
+#pragma once
+#ifndef fvkFaceDetectionService_h__
+#define fvkFaceDetectionService_h__
+
+/*********************************************************************************
+created:	2026/10/23   09:40AM
+filename: 	fvkFaceDetectionService.h
+file base:	fvkFaceDetectionService
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that runs the face detection of many cameras on a fixed number
+of worker threads. Every worker has its own backend, so the model is loaded once
+per worker instead of once per camera, and every camera (client) keeps its own
+tracked face. The requests are taken by priority, then by age, a few at a time,
+and the detections are capped by a global number per second.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkAsyncFaceDetector.h"
+#include "fvkFaceDetectorBackend.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFaceDetectionServiceStats
+{
+public:
+	fvkFaceDetectionServiceStats() :
+		clients(0),
+		workers(0),
+		requests(0),
+		detections(0),
+		replaced(0),
+		detections_per_second(0),
+		duration(0)
+	{
+	}
+	int clients;					// number of connected clients.
+	int workers;					// number of worker threads.
+	long long requests;				// number of submitted frames.
+	long long detections;			// number of detections.
+	long long replaced;				// frames replaced by a newer frame of the same client before their detection.
+	double detections_per_second;	// detections in the last second.
+	double duration;				// average time of a detection in milliseconds.
+};
+
+class FVK_CAMERA_EXPORT fvkFaceDetectionService
+{
+public:
+	using ResultFunction = std::function<void(const fvkFaceResult&)>;
+
+	// Description:
+	// Default constructor.
+	fvkFaceDetectionService();
+	// Description:
+	// Destructor that stops the worker threads.
+	~fvkFaceDetectionService();
+
+	// Description:
+	// Function to load a classifier from a file (Haar or LBP cascade).
+	// It returns true on success.
+	auto loadCascadeClassifier(const std::string& _filename) -> bool;
+	// Description:
+	// Function to load the model of the given backend from a file.
+	// The model is loaded once per worker, and the workers are started again with it by submit.
+	// It returns true on success.
+	auto loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool;
+
+	// Description:
+	// Function to set the number of worker threads (each one has its own copy of the model).
+	// It stops the workers and loads the model again.
+	// Default value is 2.
+	void setWorkers(int _value);
+	// Description:
+	// Function to get the number of worker threads.
+	auto getWorkers() const -> int;
+	// Description:
+	// Function to set the maximum number of requests a worker takes at once.
+	// Default value is 4.
+	void setBatchSize(int _value);
+	// Description:
+	// Function to get the maximum number of requests a worker takes at once.
+	auto getBatchSize() const -> int;
+	// Description:
+	// Function to set the maximum number of detections per second of all the clients
+	// together (0 = no limit). The requests above it wait, and are replaced by newer frames.
+	// Default value is 0.
+	void setBudget(double _detections_per_second);
+	// Description:
+	// Function to get the maximum number of detections per second.
+	auto getBudget() const -> double;
+
+	// Description:
+	// Function to add a client. _fn is called on a worker thread with every result of the client.
+	// It returns the identifier of the client.
+	auto connect(ResultFunction _fn) -> int;
+	// Description:
+	// Function to remove a client. It waits until its running detection is finished,
+	// so _fn is not called anymore when it returns.
+	void disconnect(int _client);
+	// Description:
+	// Function to set the priority of a client (higher first).
+	// Default value is 0.
+	void setPriority(int _client, int _priority);
+	// Description:
+	// Function to request the detection in a frame downscaled by fvkFaceDetector::downscale().
+	// _scale is the value it returned, _frame_size and _seq are given back with the result.
+	// It does not block: the frame replaces the waiting frame of the client, if any.
+	// If _reset is true, the tracked face of the client is forgotten first.
+	void submit(int _client, const cv::Mat& _resized_frame, double _scale, const cv::Size& _frame_size, unsigned long long _seq, bool _reset = false);
+
+	// Description:
+	// Function to get the stats of the service.
+	auto getStats() const -> fvkFaceDetectionServiceStats;
+	// Description:
+	// Function that stops the worker threads (they are started again by submit).
+	void stop();
+
+private:
+	// Description:
+	// One camera with its tracked face and its waiting frame.
+	struct Client
+	{
+		fvkFaceDetector fd;				// used by one worker at a time.
+		ResultFunction fn;
+		int priority;
+		cv::Mat pending;
+		double scale;
+		cv::Size size;
+		unsigned long long seq;
+		int64 submitted;				// tick count of the waiting frame.
+		bool has_pending;
+		bool reset;
+		bool busy;						// a worker is running its detection.
+	};
+
+	// Description:
+	// One frame taken by a worker.
+	struct Request
+	{
+		Client* client;
+		cv::Mat frame;
+		double scale;
+		cv::Size size;
+		unsigned long long seq;
+		bool reset;
+	};
+
+	void run(std::shared_ptr<fvkFaceDetectorBackend> _backend);
+	auto takeBatch(std::vector<Request>& _batch, double& _wait) -> bool;
+
+	std::vector<std::shared_ptr<fvkFaceDetectorBackend>> m_backends;	// one per worker.
+	std::vector<std::thread> m_threads;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::condition_variable m_idle;
+	bool m_stop;
+
+	fvkFaceDetectorBackend::Type m_type;
+	std::string m_filename;
+	int m_workers;
+	int m_batch;
+	double m_budget;
+	double m_tokens;					// detections that can start now within the budget.
+	int64 m_refill;						// tick count of the last refill of the tokens.
+
+	std::map<int, std::unique_ptr<Client>> m_clients;
+	int m_nextid;
+	std::deque<int64> m_recent;			// tick counts of the detections of the last second.
+	double m_totalduration;
+	fvkFaceDetectionServiceStats m_stats;
+};
+
+}
+
+#endif // fvkFaceDetectionService_h__
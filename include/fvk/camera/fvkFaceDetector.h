@@ -23,9 +23,13 @@ purpose:	Class to detect face in the specified frame.
 **********************************************************************************/
 
 #include "fvkCameraExport.h"
+#include "fvkDetectionSchedule.h"
+#include "fvkFaceDetectorBackend.h"
+#include "fvkFramePyramid.h"
 
 #include <opencv2/core.hpp>
 #include <opencv2/objdetect/objdetect.hpp>
+#include <memory>
 #include <string>
 
 namespace R3D
@@ -38,7 +42,7 @@ public:
 	// Default constructor to initiate the object.
 	fvkFaceDetector();
 	// Description:
-	// Default destructor that deletes the cascade.
+	// Default destructor.
 	~fvkFaceDetector();
 
 	// Description:
@@ -47,10 +51,22 @@ public:
 
 	// Description:
 	// Function to load a classifier from a file.
+	// The backend is a Haar or an LBP cascade depending on the features of the file.
 	auto setFaceCascade(const std::string& _cascade_file_path) -> bool;
 	// Description:
-	// Function to get a pointer to face cascade.
-	auto getFaceCascade() const { return m_face_cascade; }
+	// Function to switch to another algorithm that finds the faces, with its model file.
+	// The current backend is kept if the model cannot be loaded.
+	auto setBackend(fvkFaceDetectorBackend::Type _type, const std::string& _model_file_path) -> bool;
+	// Description:
+	// Function to use a backend that is loaded elsewhere, for example by the worker of a
+	// detection service that runs the detection of several cameras. The tracked face is kept.
+	void shareBackend(const std::shared_ptr<fvkFaceDetectorBackend>& _backend);
+	// Description:
+	// Function to get a pointer to the backend (nullptr if none is loaded).
+	auto getBackend() const { return m_backend.get(); }
+	// Description:
+	// Function to get a pointer to face cascade (nullptr if the backend is not a cascade).
+	auto getFaceCascade() const -> cv::CascadeClassifier*;
 	// Description:
 	// Function to get a rectangle around the detected face.
 	auto getRect() const -> cv::Rect;
@@ -76,6 +92,30 @@ public:
 	// Function that detects the biggest face in the given frame and track it.
 	auto detect(cv::Mat& _frame) -> cv::Point;
 	// Description:
+	// Function that detects the biggest face in the frame of _pyramid and track it,
+	// with the downscaled copy of the pyramid.
+	auto detect(fvkFramePyramid& _pyramid) -> cv::Point;
+	// Description:
+	// Function that detects and tracks the face in a frame that is already downscaled
+	// by downscale(), so the detection can be done on another thread than the downscaling.
+	// _scale is the value returned by downscale().
+	auto detectResized(const cv::Mat& _resized_frame, double _scale) -> cv::Point;
+	// Description:
+	// Function that downscales _frame to _width pixels (keeping the aspect ratio) for the detection.
+	// It returns the scale, or 0 if the frame is not at least twice as wide, in which case
+	// the frame is not used for the detection.
+	static auto downscale(const cv::Mat& _frame, cv::Mat& _resized_frame, int _width) -> double;
+	// Description:
+	// Overloaded function that takes the downscaled copy from a pyramid, so it is shared with
+	// the other users of the frame. The pixels of _resized_frame must not be modified.
+	static auto downscale(fvkFramePyramid& _pyramid, cv::Mat& _resized_frame, int _width) -> double;
+	// Description:
+	// Function that returns true if a face is being tracked.
+	auto isFaceFound() const -> bool;
+	// Description:
+	// Function that returns true if the cascade lost the face and it is followed by template matching.
+	auto isTemplateMatchingRunning() const -> bool;
+	// Description:
 	// Overloaded operator of the above function.
 	auto operator >> (cv::Mat& _frame) -> cv::Point;
 
@@ -86,15 +126,21 @@ private:
 	static auto getFaceTemplate(const cv::Mat& _frame, cv::Rect _face) -> cv::Mat;
 	void detectFaceAroundRoi(const cv::Mat& _frame);
 	void detectFacesTemplateMatching(const cv::Mat& _frame);
+	auto matchFaceTemplate(const cv::Mat& _image) -> cv::Point;
+	void updatePosition(const cv::Point& _position);
 
 	static const double TICK_FREQUENCY;
 
-	cv::CascadeClassifier* m_face_cascade;
+	std::shared_ptr<fvkFaceDetectorBackend> m_backend;
 	std::vector<cv::Rect> m_all_faces;
 	cv::Rect m_tracked_face;
 	cv::Rect m_face_roi;
 	cv::Mat m_face_template;
 	cv::Mat m_matching_result;
+	cv::Mat m_pyr_image;			// half resolution search window.
+	cv::Mat m_pyr_template;			// half resolution template.
+	cv::Mat m_refined_result;		// matching result of the full resolution refinement.
+	cv::Point m_face_velocity;		// motion of the face in the last frame.
 	bool m_template_matching_running;
 	int64 m_template_matching_start_time;
 	int64 m_template_matching_current_time;
@@ -121,21 +167,39 @@ public:
 	// It returns true on success.
 	auto loadCascadeClassifier(const std::string& _filename) -> bool;
 	// Description:
+	// Function to load the model of the given backend from a file.
+	// It returns true on success.
+	auto loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool;
+	// Description:
 	// Function to get the file path of the classifier.
 	auto getCascadeClassifierFilePath() const { return m_filepath; }
+	// Description:
+	// Function to get the type of the backend of the classifier.
+	auto getBackendType() const { return m_type; }
 
 	// Description:
 	// Function to get a reference to face detector.
 	auto& get() { return m_fd; }
 
+	// Description:
+	// Function to get a reference to the schedule that decides on which frames the detection runs.
+	auto& schedule() { return m_schedule; }
+
 	// Description:
 	// Function that detect all the faces in the given frame.
 	// It selects the biggest face for tracking.
+	// The detection runs at least every (_frame_delay_in_detection + 1) frames, at once on a scene
+	// change or a lost face, and less often while the face is stable (see fvkDetectionSchedule).
 	virtual void detect(cv::Mat& _frame, const int _frame_delay_in_detection = 5);
+	// Description:
+	// Overloaded function that takes the downscaled copies from the pyramid of the frame.
+	virtual void detect(fvkFramePyramid& _pyramid, const int _frame_delay_in_detection = 5);
 
 protected:
 	std::string m_filepath;
+	fvkFaceDetectorBackend::Type m_type;
 	fvkFaceDetector m_fd;
+	fvkDetectionSchedule m_schedule;
 	int m_nframes;
 };
 
@@ -0,0 +1,129 @@
+#pragma once
+#ifndef fvkFaceDetectorBackend_h__
+#define fvkFaceDetectorBackend_h__
+
+/*********************************************************************************
+created:	2026/10/22   02:20PM
+filename: 	fvkFaceDetectorBackend.h
+file base:	fvkFaceDetectorBackend
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	interface of the algorithms that find the faces for fvkFaceDetector,
+with a Haar cascade, an LBP cascade and a HOG detector.
+As a rule of thumb, LBP cascades are several times faster than Haar cascades for
+a slightly lower recall, and HOG is the slowest but the least sensitive to lighting;
+examples/benchmark_face_detectors measures them on your own images.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/core.hpp>
+#include <opencv2/objdetect/objdetect.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFaceDetectorBackend
+{
+public:
+	enum class Type
+	{
+		Haar,		// Haar cascade (haarcascade_frontalface_*.xml).
+		Lbp,		// LBP cascade (lbpcascade_frontalface*.xml).
+		Hog			// HOG descriptor with a linear SVM trained on faces (saved by cv::HOGDescriptor::save).
+	};
+
+	// Description:
+	// Default destructor.
+	virtual ~fvkFaceDetectorBackend() = default;
+
+	// Description:
+	// Function that creates a backend of the given type.
+	static auto create(Type _type) -> std::unique_ptr<fvkFaceDetectorBackend>;
+	// Description:
+	// Function that creates a cascade backend for the given file with the type of its features
+	// (Haar or LBP). It returns nullptr if the file cannot be loaded.
+	static auto createFromCascade(const std::string& _filename) -> std::unique_ptr<fvkFaceDetectorBackend>;
+	// Description:
+	// Function to get the name of a type.
+	static auto name(Type _type) -> std::string;
+
+	// Description:
+	// Function to get the type of the backend.
+	virtual auto type() const -> Type = 0;
+	// Description:
+	// Function to load the model from a file.
+	// It returns true on success.
+	virtual auto load(const std::string& _filename) -> bool = 0;
+	// Description:
+	// Function that returns true if no model is loaded.
+	virtual auto empty() const -> bool = 0;
+	// Description:
+	// Function that finds the faces from _min_size to _max_size in a grayscale image.
+	virtual void detect(const cv::Mat& _gray, std::vector<cv::Rect>& _faces, const cv::Size& _min_size, const cv::Size& _max_size) = 0;
+};
+
+class FVK_CAMERA_EXPORT fvkCascadeBackend : public fvkFaceDetectorBackend
+{
+public:
+	// Description:
+	// Constructor for a Haar or an LBP cascade.
+	explicit fvkCascadeBackend(Type _type);
+
+	auto type() const -> Type override;
+	// Description:
+	// Function to load a cascade. It fails if the features of the file are not of the type of the backend.
+	auto load(const std::string& _filename) -> bool override;
+	auto empty() const -> bool override;
+	void detect(const cv::Mat& _gray, std::vector<cv::Rect>& _faces, const cv::Size& _min_size, const cv::Size& _max_size) override;
+
+	// Description:
+	// Function to get a reference to the cascade.
+	auto& get() { return m_cascade; }
+
+private:
+	Type m_type;
+	cv::CascadeClassifier m_cascade;
+};
+
+class FVK_CAMERA_EXPORT fvkHogBackend : public fvkFaceDetectorBackend
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkHogBackend();
+
+	auto type() const -> Type override;
+	auto load(const std::string& _filename) -> bool override;
+	auto empty() const -> bool override;
+	// Description:
+	// Function that finds the faces. The image is downscaled so that _min_size matches the
+	// window of the descriptor, which is the smallest face it can find.
+	void detect(const cv::Mat& _gray, std::vector<cv::Rect>& _faces, const cv::Size& _min_size, const cv::Size& _max_size) override;
+
+	// Description:
+	// Function to get a reference to the descriptor.
+	auto& get() { return m_hog; }
+
+private:
+	cv::HOGDescriptor m_hog;
+	cv::Mat m_resized;
+};
+
+}
+
+#endif // fvkFaceDetectorBackend_h__
@@ -0,0 +1,90 @@
+#pragma once
+#ifndef fvkFastFilters_h__
+#define fvkFastFilters_h__
+
+/*********************************************************************************
+created:	2026/10/19   10:12AM
+filename: 	fvkFastFilters.h
+file base:	fvkFastFilters
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class with fast approximations of the expensive smoothing filters
+whose cost does not grow (or grows very slowly) with the kernel size.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/core.hpp>
+
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFastFilters
+{
+public:
+	// Description:
+	// Constant-time median filter (Perreault and Hebert, 2007) for 8-bit images
+	// with 1, 3 or 4 channels. Every channel is filtered independently.
+	// _ksize is the aperture linear size; it must be odd and greater than 1.
+	// Border pixels are replicated, same as cv::medianBlur.
+	// The cost per pixel is independent of _ksize, so it is only worth using
+	// for kernels bigger than 5 where cv::medianBlur becomes slow.
+	// It returns false if the image type is not supported.
+	static auto medianFilter(const cv::Mat& _src, cv::Mat& _dst, int _ksize) -> bool;
+
+	// Description:
+	// Bilateral grid approximation (Chen, Paris and Durand, 2007) of the bilateral filter
+	// for 8-bit images with 1, 3 or 4 channels.
+	// Color images are filtered with their luma as the range (edge-stopping) image.
+	// _sigma_color is the filter sigma in the intensity space.
+	// _sigma_space is the filter sigma in the coordinate space (in pixels).
+	// The cost is linear in the number of pixels plus the size of the grid,
+	// which becomes smaller for bigger sigmas.
+	// It returns false if the image type is not supported.
+	static auto bilateralFilter(const cv::Mat& _src, cv::Mat& _dst, double _sigma_color, double _sigma_space) -> bool;
+
+	// Description:
+	// Gaussian blur approximated by three stacked box blurs (running sums)
+	// for 8-bit images with 1 to 4 channels. The cost per pixel does not depend on _sigma.
+	// Border pixels are reflected (BORDER_REFLECT_101), same as cv::GaussianBlur.
+	// It returns false if the image type is not supported.
+	static auto gaussianBlur(const cv::Mat& _src, cv::Mat& _dst, double _sigma) -> bool;
+
+	// Description:
+	// Function that computes _dst = _alpha * _src + _beta * gaussian(_src, _sigma)
+	// where the weighted sum is fused into the last pass of the blur,
+	// so no intermediate blurred image is written.
+	// The default weights sharpen the image (unsharp masking).
+	// _buffer (optional) keeps the intermediate float planes between the calls of the
+	// caller, e.g. for the frames of a camera; it is reallocated when the frame size changes.
+	// It returns false if the image type is not supported.
+	static auto unsharpMask(const cv::Mat& _src, cv::Mat& _dst, double _sigma, double _alpha = 1.5, double _beta = -0.5, std::vector<float>* _buffer = nullptr) -> bool;
+
+	// Description:
+	// 3x3 convolution with integer weights for 8-bit images with 1 to 4 channels,
+	// _dst = saturate((sum(_kernel * _src) >> _shift) + _delta), rounded to the nearest.
+	// _kernel has 9 weights in row order; with _shift 0 it gives the same result as cv::filter2D.
+	// If _lut is not null, every source value is first mapped through the 256 entry table,
+	// so the point filters that come before the convolution cost no extra pass.
+	// Border pixels are reflected (BORDER_REFLECT_101), same as cv::filter2D.
+	// _dst can be the same as _src.
+	// It returns false if the image type is not supported.
+	static auto convolve3x3(const cv::Mat& _src, cv::Mat& _dst, const int _kernel[9], int _delta = 0, int _shift = 0, const uchar* _lut = nullptr) -> bool;
+};
+
+}
+
+#endif // fvkFastFilters_h__
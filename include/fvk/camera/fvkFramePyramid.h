@@ -0,0 +1,90 @@
+#pragma once
+#ifndef fvkFramePyramid_h__
+#define fvkFramePyramid_h__
+
+/*********************************************************************************
+created:	2026/10/23   02:15PM
+filename: 	fvkFramePyramid.h
+file base:	fvkFramePyramid
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that caches the downscaled copies of one frame, so the motion
+gate, the detection schedule and the face detectors that need the frame at the
+same width share one resize per frame. The copies are made on demand, each one
+from the smallest cached copy that is still big enough.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/core.hpp>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkFramePyramid
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkFramePyramid();
+	// Description:
+	// Constructor for the given frame.
+	explicit fvkFramePyramid(const cv::Mat& _frame);
+
+	// Description:
+	// Function to start with a new frame. The cached copies of the previous frame are released,
+	// not overwritten, so a copy that was handed to another thread stays valid.
+	// The frame is not copied, so it must not change while the pyramid is used.
+	void reset(const cv::Mat& _frame);
+	// Description:
+	// Function that returns true if the pyramid is made for _frame (same pixels in memory).
+	auto isOf(const cv::Mat& _frame) const -> bool;
+	// Description:
+	// Function to get the frame.
+	auto frame() const -> const cv::Mat& { return m_frame; }
+	// Description:
+	// Function that returns true if there is no frame.
+	auto empty() const -> bool { return m_frame.empty(); }
+
+	// Description:
+	// Function to get the frame downscaled to _width pixels with the same aspect ratio (area
+	// interpolation). It is the frame itself if _width is not smaller than the frame.
+	// The pixels of the result must not be modified, because they are shared by all the callers.
+	auto level(int _width) -> cv::Mat;
+	// Description:
+	// Function to get the gray version of level(_width).
+	auto gray(int _width) -> cv::Mat;
+	// Description:
+	// Function to get the number of copies made for the current frame.
+	auto getLevels() const -> int;
+
+private:
+	struct Level
+	{
+		int width;
+		cv::Mat image;
+		cv::Mat gray;
+	};
+
+	auto find(int _width) -> Level*;
+
+	cv::Mat m_frame;
+	cv::Mat m_framegray;
+	std::vector<Level> m_levels;		// sorted by decreasing width.
+};
+
+}
+
+#endif // fvkFramePyramid_h__
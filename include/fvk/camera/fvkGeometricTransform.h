@@ -0,0 +1,77 @@
+#pragma once
+#ifndef fvkGeometricTransform_h__
+#define fvkGeometricTransform_h__
+
+/*********************************************************************************
+created:	2026/10/19   04:10PM
+filename: 	fvkGeometricTransform.h
+file base:	fvkGeometricTransform
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that combines zoom, flip and rotation of a frame into one
+affine transform and applies it with a single remap.
+The fixed-point remap tables are cached and only rebuilt when the frame size
+or one of the parameters changes.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/core.hpp>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkGeometricTransform
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkGeometricTransform();
+
+	// Description:
+	// Function that zooms, flips and rotates _src in this order (the same order as
+	// fvkImageProcessing) with one remap.
+	// _zoomed_size is the frame size after the zoom (_src.size() for no zoom).
+	// _flip_rows flips the zoomed frame around the x-axis (like cv::flip with 0) and
+	// _flip_cols around the y-axis (like cv::flip with 1).
+	// _angle is the counter-clockwise rotation in degrees. 90, 180 and 270 rotate the
+	// whole frame (90 and 270 swap its width and height), any other angle rotates it
+	// around its center and keeps its size.
+	// Transforms that only move whole pixels use nearest neighbor sampling, so they are exact.
+	// It returns false and leaves _dst untouched if the transform is the identity.
+	auto apply(const cv::Mat& _src, cv::Mat& _dst, const cv::Size& _zoomed_size, bool _flip_rows, bool _flip_cols, double _angle) -> bool;
+
+	// Description:
+	// Function to release the cached remap tables.
+	void clear();
+
+private:
+	// Description:
+	// Rebuilds the remap tables for the current parameters.
+	void build();
+
+	cv::Mat m_map1;		// integer source coordinates (CV_16SC2).
+	cv::Mat m_map2;		// interpolation table indices (CV_16UC1), empty for nearest neighbor.
+	cv::Size m_srcsize;
+	cv::Size m_zoomsize;
+	cv::Size m_dstsize;
+	bool m_fliprows;
+	bool m_flipcols;
+	double m_angle;
+	int m_border;
+};
+
+}
+
+#endif // fvkGeometricTransform_h__
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef fvkHalftone_h__
+#define fvkHalftone_h__
+
+/*********************************************************************************
+created:	2026/10/19   06:30PM
+filename: 	fvkHalftone.h
+file base:	fvkHalftone
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that renders a frame as a pattern of colored dots (halftone).
+Every block of the frame becomes an anti-aliased dot with the mean color
+of the block.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+
+#include <opencv2/core.hpp>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkHalftone
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkHalftone();
+
+	// Description:
+	// Function that renders _src as dots of _block_size pixels into _dst.
+	// _src should be an 8-bit image with 1, 3 or 4 channels and _dst is always
+	// a 3 channel (BGR) image.
+	// The dot mask is cached and only rendered again when the frame size or _block_size changes.
+	// It returns false if the image type or the block size is not supported.
+	auto apply(const cv::Mat& _src, cv::Mat& _dst, int _block_size) -> bool;
+
+private:
+	// Description:
+	// Renders the dot mask and converts it to Q15 fixed-point weights.
+	void buildMask(const cv::Size& _size, int _block_size);
+
+	cv::Mat m_weight;	// dot weights (CV_16UC1), 32768 is the full color.
+	cv::Size m_size;
+	int m_block;
+};
+
+}
+
+#endif // fvkHalftone_h__
@@ -23,9 +23,16 @@ purpose:	class to do some basic image processing.
 **********************************************************************************/
 
 #include "fvkFaceDetector.h"
+#include "fvkFramePyramid.h"
+#include "fvkAsyncFaceDetector.h"
+#include "fvkMultiFaceTracker.h"
+#include "fvkGeometricTransform.h"
+#include "fvkEqualizer.h"
+#include "fvkHalftone.h"
 
 #include "opencv2/opencv.hpp"
 #include <mutex>
+#include <vector>
 
 namespace R3D
 {
@@ -59,6 +66,16 @@ public:
 		NL_Mean		// Non-local Means Denoising algorithm
 	};
 
+	// Description:
+	// Quality/speed modes of the filters that have a fast approximation.
+	// Exact uses the reference OpenCV implementation.
+	// Fast uses an approximation whose cost does not grow with the filter size.
+	enum class FilterQuality
+	{
+		Exact = 0,
+		Fast
+	};
+
 	// Description:
 	// Function to set denoising/smoothing method.
 	// Default value is DenoisingMethod::Bilateral.
@@ -75,6 +92,15 @@ public:
 	// Description:
 	// Function to get denoising/smoothing level/kernel.
 	auto getDenoisingLevel() -> int;
+	// Description:
+	// Function to set the quality/speed mode of denoising/smoothing.
+	// FilterQuality::Fast uses a constant-time histogram median for the Median method
+	// (kernels bigger than 5) and a bilateral grid for the Bilateral method.
+	// Default value is FilterQuality::Exact.
+	void setDenoisingQuality(FilterQuality _value);
+	// Description:
+	// Function to get the quality/speed mode of denoising/smoothing.
+	auto getDenoisingQuality() -> FilterQuality;
 
 	// Description:
 	// Function to set sharpness to the image.
@@ -124,6 +150,16 @@ public:
 	// Function to get the stylization value.
 	// Default value is 0.
 	auto getStylizationLevel() -> int;
+	// Description:
+	// Function to set the quality/speed mode of the non-photorealistic filters
+	// (smoothness, details, pencil sketch and stylization).
+	// FilterQuality::Fast uses the multi-threaded domain transform engine of this library,
+	// which also supports 1 and 4 channel images.
+	// Default value is FilterQuality::Exact.
+	void setNonPhotorealisticQuality(FilterQuality _value);
+	// Description:
+	// Function to get the quality/speed mode of the non-photorealistic filters.
+	auto getNonPhotorealisticQuality() -> FilterQuality;
 
 	// Description:
 	// Function to adjust the brightness of the image.
@@ -336,6 +372,10 @@ public:
 	// It returns true on success.
 	auto loadCascadeClassifier(const std::string& _filename) -> bool;
 	// Description:
+	// Function to switch the face detection to another backend (Haar, LBP or HOG)
+	// with its model file. It returns true on success.
+	auto loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool;
+	// Description:
 	// Function to turn ON/OFF face tracking.
 	// Default value is false.
 	void setFaceDetectionEnabled(bool _value);
@@ -345,15 +385,48 @@ public:
 	// Description:
 	// Function to get a reference to face detector.
 	auto& getSimpleFaceDetector() { return m_ft; }
+	// Description:
+	// Function to turn ON/OFF the asynchronous face detection. When it is ON, the cascade runs on
+	// its own thread with a downscaled copy of the frames, so it does not stall the processing,
+	// and every frame gets the latest result (extrapolated to that frame, see fvkAsyncFaceDetector).
+	// When it is OFF, the detection is done by preProcessing, so its result belongs to that frame.
+	// Default value is true.
+	void setAsyncFaceDetectionEnabled(bool _value);
+	// Description:
+	// Function that returns true if the face detection is asynchronous.
+	auto isAsyncFaceDetectionEnabled() -> bool;
+	// Description:
+	// Function to get a reference to the asynchronous face detector.
+	auto& getAsyncFaceDetector() { return m_aft; }
+	// Description:
+	// Function to turn ON/OFF the tracking of several faces. When it is ON (and face detection
+	// is enabled), preProcessing tracks every face with fvkMultiFaceTracker on the downscaled
+	// copies of the frame: the full frame is searched only on its schedule and the known faces
+	// in a small region around them, instead of a full search per frame. All the faces are drawn.
+	// Default value is false.
+	void setMultiFaceTrackingEnabled(bool _value);
+	// Description:
+	// Function that returns true if several faces are tracked.
+	auto isMultiFaceTrackingEnabled() -> bool;
+	// Description:
+	// Function to get a reference to the multi-face tracker.
+	auto& getMultiFaceTracker() { return m_mft; }
+	// Description:
+	// Function to get the faces tracked in the last frame given to preProcessing
+	// (empty if the tracking of several faces is OFF).
+	auto getTrackedFaces() -> std::vector<fvkTrackedFace>;
 
 	// Description:
-	// Function to clips a color to max values when it falls outside of the specified range.
-	// _value should be between 0 and 100.
-	static void setDenoisingFilter(cv::Mat& _img, int _value, fvkImageProcessing::DenoisingMethod _method);
+	// Function to denoise/smooth the image with the specified method.
+	// _value is the kernel size and it should be an odd number.
+	// _quality selects the exact OpenCV filter or its fast approximation (Median and Bilateral only).
+	static void setDenoisingFilter(cv::Mat& _img, int _value, fvkImageProcessing::DenoisingMethod _method, fvkImageProcessing::FilterQuality _quality = fvkImageProcessing::FilterQuality::Exact);
 	// Description:
 	// Function to apply various kinds of image processing filters such as sharpen an image.
-	// _value should be between 0 and 100.
-	static void setWeightedFilter(cv::Mat& _img, int _value, double _alpha = 1.5, double _beta = -0.5);
+	// _value should be between 0 and 100. It is the sigma of the gaussian blur and
+	// values from 4 use a constant-time approximation of the gaussian blur, whose
+	// intermediate planes are kept in _buffer if it is given (see fvkFastFilters::unsharpMask).
+	static void setWeightedFilter(cv::Mat& _img, int _value, double _alpha = 1.5, double _beta = -0.5, std::vector<float>* _buffer = nullptr);
 	// Description:
 	// Flip directions.
 	enum class Filters
@@ -367,7 +440,8 @@ public:
 	// Function to do non-photorealistic rendering on the given image. 
 	// _value should be between 0 and 200.
 	// _sigma should be between 0 and 1.
-	static void setNonPhotorealisticFilter(cv::Mat& _img, int _value, float _sigma, fvkImageProcessing::Filters _filter);
+	// _quality selects the OpenCV filters (3 channel images only) or the fvkDomainTransform engine.
+	static void setNonPhotorealisticFilter(cv::Mat& _img, int _value, float _sigma, fvkImageProcessing::Filters _filter, fvkImageProcessing::FilterQuality _quality = fvkImageProcessing::FilterQuality::Exact);
 	// Description:
 	// Function to adjust the brightness of the image.
 	// _value should be between -100 and 100.
@@ -382,6 +456,7 @@ public:
 	// Function to adjust the color contrast of the image.
 	// _value should be between -100 and 100.
 	// _value less than 0 will decrees the contrast while values greater than 0 will increase it.
+	// It is a table lookup, like the exposure filter.
 	static void setColorContrastFilter(cv::Mat& _img, int _value);
 	// Description:
 	// Function to adjust the color saturation of the image.
@@ -395,7 +470,8 @@ public:
 	static void setVibranceFilter(cv::Mat& _img, int _value);
 	// Description:
 	// Function to adjust the hue of the image.
-	// _value should be between 0 and 100.
+	// _value should be between 0 and 100. One unit rotates the hue by 2 degrees (as the 8-bit HSV hue)
+	// and the rotation wraps around, the luma of the pixels is preserved.
 	static void setHueFilter(cv::Mat& _img, int _value);
 	// Description:
 	// Function to adjust the gamma of the image.
@@ -408,28 +484,151 @@ public:
 	// Description:
 	// Function to adjust the sepia filter to the image.
 	// _value should be between 0 and 100.
+	// It is computed with 32-bit fixed-point arithmetic and it is within 1 of setSepiaFilterReference.
 	static void setSepiaFilter(cv::Mat& _img, int _value);
 	// Description:
+	// Former floating-point implementations of the color contrast, exposure and sepia filters,
+	// which are only kept to validate the integer implementations.
+	static void setColorContrastFilterReference(cv::Mat& _img, int _value);
+	static void setExposureFilterReference(cv::Mat& _img, int _value);
+	static void setSepiaFilterReference(cv::Mat& _img, int _value);
+	// Description:
+	// Function that compares the color contrast, exposure and sepia filters with their reference
+	// implementations over _frames random frames (color and gray) with random values.
+	// It returns the maximum difference of a channel, which is expected to be 0 or 1.
+	static auto validatePointFilters(int _frames = 8, const cv::Size& _size = cv::Size(640, 480)) -> int;
+	// Description:
 	// Function to clips a color to max values when it falls outside of the specified range.
 	// _value should be between 0 and 100.
 	static void setClipFilter(cv::Mat& _img, int _value);
 	// Description:
-	// Function to clips a color to max values when it falls outside of the specified range.
-	// _value should be between 0 and 100.
+	// Function to apply the light emboss filter (3x3 integer convolution).
+	// If _negative is true, the image is inverted in the same pass, before the emboss.
+	static void setEmbossFilter(cv::Mat& _img, bool _negative = false);
+	// Description:
+	// Function to equalize the luma of the image with adaptive histogram equalization (CLAHE).
+	// Chroma and the alpha channel are preserved.
 	static void setEqualizeFilter(cv::Mat& _img, double _cliplimit, cv::Size _tile_grid_size = cv::Size(8, 8));
 
 	// Description:
 	// Function to perform image processing algorithms.
+	// It is the same as calling preProcessing, filterProcessing and postProcessing in this order.
 	virtual void imageProcessing(cv::Mat& _frame);
+	// Description:
+	// Function to perform the stages that depend on the previous frames, which are the
+	// geometric transform and the face detection (tracking). The frames must be passed to it in
+	// their capture order. It returns the rectangle of the tracked face (empty if face
+	// detection is disabled) that is passed to postProcessing.
+	auto preProcessing(cv::Mat& _frame) -> cv::Rect;
+	// Description:
+	// Overloaded function for a frame whose downscaled copies are shared with other stages
+	// (such as fvkMotionGate). _pyramid must be made for _frame; it is reset with the new
+	// frame if the geometric transform or the gray conversion replaces it.
+	auto preProcessing(cv::Mat& _frame, fvkFramePyramid& _pyramid) -> cv::Rect;
+	// Description:
+	// Function to perform all the filters of imageProcessing. It does not depend on the previous
+	// frames, so the frames can be processed concurrently by several objects with the same settings.
+	void filterProcessing(cv::Mat& _frame);
+	// Description:
+	// Function that draws the tracked face _face (returned by preProcessing) on the frame,
+	// or the faces _faces (getTrackedFaces after preProcessing) when several faces are tracked.
+	void postProcessing(cv::Mat& _frame, const cv::Rect& _face, const std::vector<fvkTrackedFace>& _faces = std::vector<fvkTrackedFace>());
+
+	// Description:
+	// Stages of imageProcessing in the order they are applied.
+	enum class Stage
+	{
+		Geometry = 0,
+		FaceDetection,
+		Denoising,
+		Smoothness,
+		Equalize,
+		Sharpening,
+		Details,
+		PencilSketch,
+		Stylization,
+		Brightness,
+		Contrast,
+		ColorContrast,
+		Saturation,
+		Vibrance,
+		Hue,
+		Exposure,
+		Gamma,
+		Sepia,
+		Clip,
+		Negative,
+		Emboss,
+		Dots,
+		ConvertColor,
+		Output
+	};
+	// Description:
+	// Function that returns the time (in milliseconds) spent in every stage (indexed by Stage)
+	// the last time the stage was run by this object. Inactive stages take (almost) no time.
+	// The conversions to gray, the processing scale and the threshold are counted in the
+	// stage they are done in.
+	auto getStageTimes() -> std::vector<double>;
+
+	// Description:
+	// Quality reductions applied on top of the settings, normally by fvkQualityGovernor.
+	// They do not change the values returned by the getters, so removing them restores
+	// the settings as they were.
+	class QualityReduction
+	{
+	public:
+		QualityReduction() :
+			denoise_level_max(0),
+			processing_scale(100),
+			face_detection_interval(0),
+			fast_npr(false)
+		{
+		}
+		int denoise_level_max;			// maximum denoising kernel (0 = not limited).
+		int processing_scale;			// frame size (percentage) at which the filters are run.
+		int face_detection_interval;	// minimum number of frames between face detections (0 = not limited).
+		bool fast_npr;					// use FilterQuality::Fast for the non-photorealistic filters.
+	};
+	// Description:
+	// Function to set the quality reductions.
+	// Default value is QualityReduction(), which does not reduce anything.
+	void setQualityReduction(const QualityReduction& _value);
+	// Description:
+	// Function to get the quality reductions.
+	auto getQualityReduction() -> QualityReduction;
+
+	// Description:
+	// Function that copies all the settings (not the face detector) of the given object into this object.
+	void copySettings(fvkImageProcessing& _other);
+	// Description:
+	// Function that returns a number which is incremented whenever a setting is changed.
+	auto getSettingsRevision() -> unsigned;
 
 private:
+	// Description:
+	// Function that returns true if the stage is active and its result depends on the colors,
+	// i.e. it can not run on the gray image when the output is single-channel.
+	auto isColorStage(Stage _stage) const -> bool;
+	// Description:
+	// Function that returns the stage before which the frame is converted to gray, which is
+	// the stage after the last color stage if the output is single-channel (gray scale or threshold),
+	// or Stage::Output otherwise.
+	auto grayScaleStage() const -> Stage;
+	// Description:
+	// Functions that return the settings with the quality reductions applied.
+	auto effectiveDenoisingLevel() const -> int;
+	auto effectiveNonPhotorealisticQuality() const -> FilterQuality;
+	auto effectiveFaceDetectionInterval() const -> int;
+
 	int m_denoislevel;
 	DenoisingMethod m_denoismethod;
+	FilterQuality m_denoisquality;
 	int m_sharplevel;
 	int m_smoothness;
 	int m_details;
 	int m_pencilsketch;
 	int m_stylization;
+	FilterQuality m_nprquality;
 	int m_brigtness;
 	int m_contrast;
 	int m_colorcontrast;
@@ -441,18 +640,33 @@ private:
 	int m_sepia;
 	int m_clip;
 	int m_ndots;
+	fvkHalftone m_halftone;
 	bool m_isemboss;
 	double m_rotangle;
 	bool m_isnegative;
 	int m_zoomperc;
 	FlipDirection m_flip;
+	fvkGeometricTransform m_geometry;
 	bool m_isgray;
 	int m_convertcolor;
 	int m_threshold;
 	double m_equalizelimit;
+	fvkEqualizer m_equalizer;
+	std::vector<float> m_sharpenplanes;		// intermediate planes of the sharpening.
 
 	bool m_isfacetrack;
 	fvkSimpleFaceDetector m_ft;
+	bool m_isfaceasync;
+	fvkAsyncFaceDetector m_aft;
+	bool m_ismultiface;
+	fvkMultiFaceTracker m_mft;
+	std::vector<fvkTrackedFace> m_faces;	// faces of m_mft in the last frame.
+	unsigned long long m_faceseq;			// sequence number of the frames given to m_aft.
+	unsigned long long m_faceresult;		// sequence number of the last result of m_aft given to the schedule.
+
+	QualityReduction m_reduction;
+	std::vector<double> m_stagetimes;
+	unsigned m_revision;
 
 	std::mutex m_mutex;
 };
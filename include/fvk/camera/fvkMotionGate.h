@@ -0,0 +1,127 @@
+#pragma once
+#ifndef fvkMotionGate_h__
+#define fvkMotionGate_h__
+
+/*********************************************************************************
+created:	2026/10/20   02:05PM
+filename: 	fvkMotionGate.h
+file base:	fvkMotionGate
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that detects static frames cheaply, so that the processing
+thread can reuse the previous processed frame instead of processing them again.
+A small gray thumbnail of every frame is compared (sum of absolute differences)
+with the thumbnail of the last processed frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+#include "fvkFramePyramid.h"
+
+#include <opencv2/core.hpp>
+#include <mutex>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkMotionStats
+{
+public:
+	fvkMotionStats() :
+		processed(0),
+		skipped(0),
+		consecutive(0),
+		difference(0),
+		block_difference(0)
+	{
+	}
+	long long processed;		// number of frames that had to be processed.
+	long long skipped;			// number of static frames that were skipped.
+	int consecutive;			// number of frames skipped since the last processed frame.
+	double difference;			// mean absolute difference of the last frame (0 to 255).
+	double block_difference;	// maximum mean absolute difference of a block of the last frame.
+};
+
+class FVK_CAMERA_EXPORT fvkMotionGate
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkMotionGate();
+
+	// Description:
+	// Function to turn the motion gate ON/OFF.
+	// Default value is false.
+	void setEnabled(bool _value);
+	// Description:
+	// Function that returns true if the motion gate is enabled.
+	auto isEnabled() const -> bool;
+
+	// Description:
+	// Function to set the thresholds of the difference between a frame and the last processed
+	// frame, below which the frame is static. Both are mean absolute differences of the gray
+	// thumbnails (0 to 255); _mean is for the whole thumbnail and _block for any of its 8x8 blocks,
+	// so that a small moving object is not missed.
+	// Default values are 1.5 and 6.
+	void setThresholds(double _mean, double _block);
+	// Description:
+	// Function to get the threshold of the whole thumbnail.
+	auto getMeanThreshold() const -> double;
+	// Description:
+	// Function to get the threshold of the thumbnail blocks.
+	auto getBlockThreshold() const -> double;
+
+	// Description:
+	// Function to set the maximum number of consecutive frames that can be skipped,
+	// after which a frame is processed anyway (0 = no limit).
+	// Default value is 100.
+	void setMaxSkippedFrames(int _value);
+	// Description:
+	// Function to get the maximum number of consecutive frames that can be skipped.
+	auto getMaxSkippedFrames() const -> int;
+
+	// Description:
+	// Function that returns true if _frame is static, so its processing can be skipped.
+	// It returns false if the gate is disabled, the frame has changed, _revision (the settings
+	// revision of the image processing) has changed, or too many frames were skipped.
+	// In that case the frame must be processed, because it becomes the new reference.
+	auto isStatic(const cv::Mat& _frame, unsigned _revision) -> bool;
+	// Description:
+	// Overloaded function that takes the thumbnail from the pyramid of the frame.
+	auto isStatic(fvkFramePyramid& _pyramid, unsigned _revision) -> bool;
+	// Description:
+	// Function to forget the reference frame, so the next frame is processed.
+	void reset();
+
+	// Description:
+	// Function to get the skip counters and the last measured differences.
+	auto getStats() const -> fvkMotionStats;
+
+private:
+	mutable std::mutex m_mutex;
+	bool m_enabled;
+	double m_mean;
+	double m_block;
+	int m_maxskip;
+
+	cv::Mat m_ref;			// thumbnail of the last processed frame.
+	cv::Mat m_thumb;		// thumbnail of the current frame.
+	cv::Mat m_diff;
+	cv::Mat m_blocks;
+	unsigned m_revision;
+	fvkMotionStats m_stats;
+};
+
+}
+
+#endif // fvkMotionGate_h__
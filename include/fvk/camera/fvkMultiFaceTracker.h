@@ -0,0 +1,160 @@
+#pragma once
+#ifndef fvkMultiFaceTracker_h__
+#define fvkMultiFaceTracker_h__
+
+/*********************************************************************************
+created:	2026/10/21   05:10PM
+filename: 	fvkMultiFaceTracker.h
+file base:	fvkMultiFaceTracker
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that tracks several faces at once. Every face has its own region
+of interest, template and lost timer, the same as the single face of fvkFaceDetector.
+The full frame is only searched on a schedule or when a face is lost, and the
+tracking of the faces is capped by a time budget per frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkCameraExport.h"
+#include "fvkFramePyramid.h"
+#include "fvkFaceDetectorBackend.h"
+
+#include <opencv2/core.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkTrackedFace
+{
+public:
+	fvkTrackedFace() :
+		id(0),
+		lost(false)
+	{
+	}
+	int id;				// identifier that stays the same while the face is tracked.
+	cv::Rect rect;		// face rectangle in the coordinates of the frame.
+	bool lost;			// true if the detector lost the face and it is followed by template matching.
+};
+
+class FVK_CAMERA_EXPORT fvkMultiFaceTracker
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkMultiFaceTracker();
+
+	// Description:
+	// Function to load a classifier from a file (Haar or LBP cascade).
+	// It returns true on success.
+	auto loadCascadeClassifier(const std::string& _filename) -> bool;
+	// Description:
+	// Function to load the model of the given backend (Haar, LBP or HOG) from a file.
+	// It returns true on success.
+	auto loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool;
+	// Description:
+	// Function that returns true if a model is loaded.
+	auto isLoaded() const -> bool;
+
+	// Description:
+	// Function to set the width of the downscaled frames the faces are searched in.
+	// Default value is 320.
+	void setResizedWidth(int _width);
+	// Description:
+	// Function to get the width of the downscaled frames.
+	auto getResizedWidth() const -> int;
+	// Description:
+	// Function to set the maximum number of tracked faces.
+	// Default value is 8.
+	void setMaxFaces(int _value);
+	// Description:
+	// Function to get the maximum number of tracked faces.
+	auto getMaxFaces() const -> int;
+	// Description:
+	// Function to set the number of frames between two searches of the full frame (new faces).
+	// The interval is four times shorter while a face is lost or no face is tracked.
+	// Default value is 30.
+	void setDetectionInterval(int _frames);
+	// Description:
+	// Function to get the number of frames between two searches of the full frame.
+	auto getDetectionInterval() const -> int;
+	// Description:
+	// Function to set the time budget in milliseconds for the tracking of the faces in a frame.
+	// The faces are tracked in turn until the budget is spent (at least one per frame), and
+	// the others keep their last position until their turn.
+	// Default value is 10.
+	void setTrackingBudget(double _msec);
+	// Description:
+	// Function to get the tracking budget in milliseconds.
+	auto getTrackingBudget() const -> double;
+	// Description:
+	// Function to set the duration in seconds after which a face that is only followed by
+	// template matching is dropped (see fvkFaceDetector::setTemplateMatchingMaxDuration).
+	// Default value is 3.
+	void setLostDuration(double _s);
+	// Description:
+	// Function to get the duration after which a lost face is dropped.
+	auto getLostDuration() const -> double;
+
+	// Description:
+	// Function that tracks the faces in the next frame and returns them.
+	auto detect(const cv::Mat& _frame) -> std::vector<fvkTrackedFace>;
+	// Description:
+	// Overloaded function that takes the downscaled gray frame from the pyramid of the frame.
+	auto detect(fvkFramePyramid& _pyramid) -> std::vector<fvkTrackedFace>;
+	// Description:
+	// Function to get the faces of the last frame.
+	auto getFaces() const -> std::vector<fvkTrackedFace>;
+	// Description:
+	// Function to forget all the faces.
+	void reset();
+
+private:
+	// Description:
+	// One tracked face in the coordinates of the downscaled frame.
+	struct Track
+	{
+		int id;
+		cv::Rect rect;
+		cv::Rect roi;
+		cv::Mat templ;
+		int64 lost_since;		// tick count when the cascade lost the face (0 if not lost).
+		bool updated;			// updated by the search of the full frame in this frame.
+	};
+
+	void detectAll(const cv::Mat& _gray);
+	void track(const cv::Mat& _gray, Track& _track);
+	void update(const cv::Mat& _gray, Track& _track, const cv::Rect& _rect);
+
+	std::unique_ptr<fvkFaceDetectorBackend> m_backend;
+	std::vector<Track> m_tracks;
+	std::vector<fvkTrackedFace> m_faces;
+	std::vector<cv::Rect> m_detected;
+	cv::Mat m_matching;
+	double m_scale;
+	int m_width;
+	int m_maxfaces;
+	int m_interval;
+	double m_budget;
+	double m_lostduration;
+	int m_frames;			// frames since the last search of the full frame (-1 before the first one).
+	std::size_t m_next;		// track to start with in the next frame.
+	int m_nextid;
+};
+
+}
+
+#endif // fvkMultiFaceTracker_h__
@@ -0,0 +1,129 @@
+#pragma once
+#ifndef fvkOfflineProcessor_h__
+#define fvkOfflineProcessor_h__
+
+/*********************************************************************************
+created:	2026/10/21   10:15AM
+filename: 	fvkOfflineProcessor.h
+file base:	fvkOfflineProcessor
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that processes a video file as fast as the hardware allows,
+e.g. to reprocess archived footage with the settings of a camera.
+One thread decodes ahead, the frames are filtered concurrently by a processing
+pool and the encoder receives them in their original order.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkImageProcessing.h"
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkOfflineStats
+{
+public:
+	fvkOfflineStats() :
+		frames(0),
+		failed(0),
+		workers(0),
+		seconds(0),
+		fps(0),
+		decode(0),
+		encode(0),
+		blocked(0)
+	{
+	}
+	long long frames;				// number of processed frames.
+	long long failed;				// frames written unfiltered because their filtering threw an exception.
+	int workers;					// number of threads that filtered the frames.
+	double seconds;					// total wall-clock time.
+	double fps;						// processed frames per second.
+	double decode;					// average decoding time per frame in milliseconds.
+	double encode;					// average encoding time per frame in milliseconds.
+	double blocked;					// average time per frame the output waited for the encoder in milliseconds.
+	std::vector<double> stages;		// average time per frame of every stage (indexed by fvkImageProcessing::Stage),
+									// summed over all the workers.
+};
+
+class FVK_CAMERA_EXPORT fvkOfflineProcessor
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkOfflineProcessor();
+
+	// Description:
+	// Function to set the number of threads that filter the frames concurrently.
+	// Default value is 0, which uses one thread per hardware core.
+	void setWorkers(int _value);
+	// Description:
+	// Function to get the number of threads that filter the frames concurrently.
+	auto getWorkers() const -> int;
+
+	// Description:
+	// Function to set the number of frames that are decoded ahead of the processing.
+	// Default value is 16.
+	void setReadAhead(int _frames);
+	// Description:
+	// Function to get the number of frames that are decoded ahead of the processing.
+	auto getReadAhead() const -> int;
+
+	// Description:
+	// Function to set the four character codec of the output file (see fvkVideoWriter::setCodec).
+	// Default value is empty, which uses the codec of the input file.
+	void setCodec(const std::string& _codec);
+	// Description:
+	// Function to get the four character codec of the output file.
+	auto getCodec() const -> std::string;
+
+	// Description:
+	// Function to set a function that is called with the number of frames written so far
+	// and the number of frames of the input file (0 if unknown), from the encoding thread.
+	void setProgressFunction(std::function<void(long long, long long)> _func);
+
+	// Description:
+	// Function that processes every frame of the video file _input with the settings of
+	// _settings (copied when the processing starts) and writes them to _output.
+	// If _output is empty, the processed frames are not encoded (e.g. to measure the processing).
+	// It blocks until the whole file is processed or cancel() is called, and returns false if
+	// the input file could not be opened or the output file could not be created.
+	auto process(const std::string& _input, const std::string& _output, fvkImageProcessing& _settings) -> bool;
+	// Description:
+	// Function to stop the processing from another thread.
+	// The frames that are already being processed are still written, the others are dropped.
+	void cancel();
+
+	// Description:
+	// Function to get the timings of the last processed file.
+	auto getStats() const -> fvkOfflineStats;
+
+private:
+	mutable std::mutex m_mutex;
+	int m_workers;
+	int m_readahead;
+	std::string m_codec;
+	std::function<void(long long, long long)> m_progress;
+	std::atomic<bool> m_cancel;
+	fvkOfflineStats m_stats;
+};
+
+}
+
+#endif // fvkOfflineProcessor_h__
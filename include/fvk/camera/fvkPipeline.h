@@ -0,0 +1,660 @@
+#pragma once
+#ifndef fvkPipeline_h__
+#define fvkPipeline_h__
+
+/*********************************************************************************
+created:	2026/10/20   04:20PM
+filename: 	fvkPipeline.h
+file base:	fvkPipeline
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	header-only filter pipeline whose stages are fixed at compile time,
+for deployments that always run the same chain of filters.
+Adjacent point operations (per-pixel filters like brightness or sepia) are
+fused into one inlined loop over the pixels, and the other stages call the
+static filters of fvkImageProcessing. Table lookup stages right before a 3x3
+convolution (e.g. Contrast, Negative, Emboss) are done by the convolution itself.
+
+Usage example:
+using namespace R3D::fvkStages;
+fvkPipeline<Flip, Equalize, Sharpen, Contrast, Sepia> p(
+	Flip(fvkImageProcessing::FlipDirection::Horizontal), Equalize(2.0), Sharpen(5), Contrast(10), Sepia(50));
+cam->getProcThread()->setProcessingFunction(std::ref(p));
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkImageProcessing.h"
+#include "fvkGeometricTransform.h"
+#include "fvkEqualizer.h"
+#include "fvkHalftone.h"
+#include "fvkFastFilters.h"
+
+#include <tuple>
+#include <initializer_list>
+#include <utility>
+#include <algorithm>
+#include <cmath>
+
+namespace R3D
+{
+
+// Description:
+// Stages of fvkPipeline.
+// Point stages (is_point is true) compute every output pixel from the same input pixel.
+// They have prepare(), which is called once per frame, and apply<CN>(), which is called for
+// every pixel of a CN channel 8-bit image. All the other stages are called with the whole frame.
+// Frame stages with accepts_lut take the composed table of the lookup stages right before them.
+// Every stage gives the same result as the fvkImageProcessing filter of the same name.
+namespace fvkStages
+{
+
+// Description:
+// Base of the point stages that are a table lookup of every channel.
+// Only the color channels of a 4 channel image are changed if ColorOnly is true.
+template <bool ColorOnly>
+struct LookupStage
+{
+	static const bool is_point = true;
+
+	template <int CN>
+	void apply(uchar* _p) const
+	{
+		const auto n = (ColorOnly && CN == 4) ? 3 : CN;
+		for (auto c = 0; c < n; c++)
+			_p[c] = lut[_p[c]];
+	}
+
+	uchar lut[256];
+};
+
+struct Brightness : LookupStage<false>
+{
+	explicit Brightness(int _value = 0) : value(_value) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto v = static_cast<double>(cvFloor(255.f * (static_cast<float>(value) / 100.f)));
+		for (auto i = 0; i < 256; i++)
+			lut[i] = cv::saturate_cast<uchar>(i + v);
+	}
+	int value;
+};
+
+struct Contrast : LookupStage<false>
+{
+	explicit Contrast(int _value = 0) : value(_value) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto v = std::pow(static_cast<double>(value + 100) / 100.0, 2.0);
+		for (auto i = 0; i < 256; i++)
+			lut[i] = cv::saturate_cast<uchar>(i * v);
+	}
+	int value;
+};
+
+struct ColorContrast : LookupStage<true>
+{
+	explicit ColorContrast(int _value = 0) : value(_value) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto v = std::pow(static_cast<float>(value + 100) / 100.f, 2.f);
+		for (auto i = 0; i < 256; i++)
+			lut[i] = cv::saturate_cast<uchar>((((static_cast<float>(i) / 255.f) - 0.5f) * v + 0.5f) * 255.f);
+	}
+	int value;
+};
+
+struct Gamma : LookupStage<false>
+{
+	explicit Gamma(int _value = 0) : value(_value) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto v = 1.0 - static_cast<double>(value) / 100.0;
+		for (auto i = 0; i < 256; i++)
+			lut[i] = static_cast<uchar>(static_cast<int>(std::pow(static_cast<double>(i) / 255.0, v) * 255.0));
+	}
+	int value;
+};
+
+struct Exposure : LookupStage<true>
+{
+	explicit Exposure(int _value = 0) : value(_value) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto f = std::pow(2.0f, -(1.f - static_cast<float>(value) / 50.f));
+		for (auto i = 0; i < 256; i++)
+		{
+			const auto p = static_cast<float>(((f * (static_cast<float>(i) / 255.f)) - 0.5f) * 1.0 + 0.5f);
+			lut[i] = cv::saturate_cast<uchar>(p > 1.0f ? 255.0f : 255.0f * p);
+		}
+	}
+	int value;
+};
+
+struct Negative : LookupStage<false>
+{
+	Negative() {}
+	auto active() const -> bool { return true; }
+	void prepare()
+	{
+		for (auto i = 0; i < 256; i++)
+			lut[i] = static_cast<uchar>(255 - i);
+	}
+};
+
+struct Clip
+{
+	static const bool is_point = true;
+	explicit Clip(int _value = 0) : value(_value), low(0), high(0) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto v = std::abs(static_cast<float>(value)) * 2.55f;
+		low = v;
+		high = 255.f - v;
+	}
+	template <int CN>
+	void apply(uchar* _p) const
+	{
+		if (CN != 3) return;
+		for (auto c = 0; c < 3; c++)
+		{
+			const auto p = static_cast<float>(_p[c]);
+			if (p > high)
+				_p[c] = 255;
+			else if (p < low)
+				_p[c] = 0;
+		}
+	}
+	int value;
+	float low;
+	float high;
+};
+
+struct Saturation
+{
+	static const bool is_point = true;
+	explicit Saturation(int _value = 0) : value(_value), amount(0) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare() { amount = value * -0.01f; }
+	template <int CN>
+	void apply(uchar* _p) const
+	{
+		if (CN != 3) return;
+		const float p[3] = { _p[0], _p[1], _p[2] };
+		const auto maxi = std::max(std::max(p[0], p[1]), p[2]);
+		for (auto c = 0; c < 3; c++)
+			_p[c] = cv::saturate_cast<uchar>(p[c] != maxi ? p[c] + (maxi - p[c]) * amount : p[c]);
+	}
+	int value;
+	float amount;
+};
+
+struct Vibrance
+{
+	static const bool is_point = true;
+	explicit Vibrance(int _value = 0) : value(_value), amount(0) {}
+	auto active() const -> bool { return value != 0; }
+	void prepare() { amount = value * -1.0f; }
+	template <int CN>
+	void apply(uchar* _p) const
+	{
+		if (CN != 3) return;
+		const float p[3] = { _p[0], _p[1], _p[2] };
+		const auto maxi = std::max(std::max(p[0], p[1]), p[2]);
+		const auto avg = (p[0] + p[1] + p[2]) / 3.f;
+		const auto amt = ((std::abs(maxi - avg) * 2.f / 255.f) * amount) / 100.f;
+		for (auto c = 0; c < 3; c++)
+			_p[c] = cv::saturate_cast<uchar>(p[c] != maxi ? p[c] + (maxi - p[c]) * amt : p[c]);
+	}
+	int value;
+	float amount;
+};
+
+struct Sepia
+{
+	static const bool is_point = true;
+	explicit Sepia(int _value = 0) : value(_value), kr(), kg(), kb() {}
+	auto active() const -> bool { return value != 0; }
+	void prepare()
+	{
+		const auto v = static_cast<double>(value) / 100.0;
+		auto q = [](double _c) { return cvRound(_c * 4096.0); };
+		kr[0] = q(0.189 * v); kr[1] = q(0.769 * v); kr[2] = q(1.0 - 0.607 * v);
+		kg[0] = q(0.168 * v); kg[1] = q(1.0 - 0.314 * v); kg[2] = q(0.349 * v);
+		kb[0] = q(1.0 - 0.869 * v); kb[1] = q(0.534 * v); kb[2] = q(0.272 * v);
+	}
+	template <int CN>
+	void apply(uchar* _p) const
+	{
+		if (CN != 3) return;
+		// Q12 arithmetic of fvkImageProcessing::setSepiaFilter; every channel uses the already
+		// changed channels before it (red, then green, then blue).
+		const int b = _p[0], g = _p[1], r = _p[2];
+		const auto r12 = std::min(kr[0] * b + kr[1] * g + kr[2] * r, 255 << 12);
+		const auto r4 = (r12 + (1 << 7)) >> 8;
+		const auto g16 = std::min(kg[2] * r4 + ((kg[0] * b + kg[1] * g) << 4), 255 << 16);
+		const auto g4 = (g16 + (1 << 11)) >> 12;
+		const auto b16 = std::min(kb[2] * r4 + kb[1] * g4 + ((kb[0] * b) << 4), 255 << 16);
+		_p[0] = static_cast<uchar>((b16 + (1 << 15)) >> 16);
+		_p[1] = static_cast<uchar>((g16 + (1 << 15)) >> 16);
+		_p[2] = static_cast<uchar>((r12 + (1 << 11)) >> 12);
+	}
+	int value;
+	int kr[3];
+	int kg[3];
+	int kb[3];
+};
+
+struct Flip
+{
+	static const bool is_point = false;
+	explicit Flip(fvkImageProcessing::FlipDirection _d = fvkImageProcessing::FlipDirection::None) : direction(_d) {}
+	void operator()(cv::Mat& _img)
+	{
+		const auto rows = direction == fvkImageProcessing::FlipDirection::Horizontal || direction == fvkImageProcessing::FlipDirection::Both;
+		const auto cols = direction == fvkImageProcessing::FlipDirection::Vertical || direction == fvkImageProcessing::FlipDirection::Both;
+		geometry.apply(_img, _img, _img.size(), rows, cols, 0);
+	}
+	fvkImageProcessing::FlipDirection direction;
+	fvkGeometricTransform geometry;
+};
+
+struct Rotate
+{
+	static const bool is_point = false;
+	explicit Rotate(double _angle = 0) : angle(_angle) {}
+	void operator()(cv::Mat& _img) { geometry.apply(_img, _img, _img.size(), false, false, angle); }
+	double angle;
+	fvkGeometricTransform geometry;
+};
+
+struct Denoise
+{
+	static const bool is_point = false;
+	explicit Denoise(int _level = 0, fvkImageProcessing::DenoisingMethod _method = fvkImageProcessing::DenoisingMethod::Gaussian, fvkImageProcessing::FilterQuality _quality = fvkImageProcessing::FilterQuality::Exact) :
+		level(_level), method(_method), quality(_quality) {}
+	void operator()(cv::Mat& _img) { if (level > 2) fvkImageProcessing::setDenoisingFilter(_img, level, method, quality); }
+	int level;
+	fvkImageProcessing::DenoisingMethod method;
+	fvkImageProcessing::FilterQuality quality;
+};
+
+struct Equalize
+{
+	static const bool is_point = false;
+	explicit Equalize(double _cliplimit = 0) : cliplimit(_cliplimit) {}
+	void operator()(cv::Mat& _img) { if (cliplimit > 0) equalizer.apply(_img, cliplimit, cv::Size(8, 8)); }
+	double cliplimit;
+	fvkEqualizer equalizer;
+};
+
+struct Sharpen
+{
+	static const bool is_point = false;
+	explicit Sharpen(int _level = 0) : level(_level) {}
+	void operator()(cv::Mat& _img) { if (level > 0) fvkImageProcessing::setWeightedFilter(_img, level, 1.5, -0.5, &planes); }
+	int level;
+	std::vector<float> planes;
+};
+
+// Description:
+// Non-photorealistic filters with the same sigmas as fvkImageProcessing.
+template <fvkImageProcessing::Filters F>
+struct NonPhotorealistic
+{
+	static const bool is_point = false;
+	explicit NonPhotorealistic(int _value = 0, fvkImageProcessing::FilterQuality _quality = fvkImageProcessing::FilterQuality::Exact) :
+		value(_value), quality(_quality) {}
+	void operator()(cv::Mat& _img)
+	{
+		if (value <= 0) return;
+		const auto sigma = F == fvkImageProcessing::Filters::Details ? 0.02f : F == fvkImageProcessing::Filters::Stylization ? 0.45f : 0.1f;
+		fvkImageProcessing::setNonPhotorealisticFilter(_img, value, sigma, F, quality);
+	}
+	int value;
+	fvkImageProcessing::FilterQuality quality;
+};
+using Smoothness = NonPhotorealistic<fvkImageProcessing::Filters::Smoothing>;
+using Details = NonPhotorealistic<fvkImageProcessing::Filters::Details>;
+using PencilSketch = NonPhotorealistic<fvkImageProcessing::Filters::PencilSketch>;
+using Stylization = NonPhotorealistic<fvkImageProcessing::Filters::Stylization>;
+
+struct Hue
+{
+	static const bool is_point = false;
+	explicit Hue(int _value = 0) : value(_value) {}
+	void operator()(cv::Mat& _img) { fvkImageProcessing::setHueFilter(_img, value); }
+	int value;
+};
+
+// Description:
+// 3x3 convolution with integer weights (see fvkFastFilters::convolve3x3).
+struct Convolution
+{
+	static const bool is_point = false;
+	static const bool accepts_lut = true;
+	Convolution(std::initializer_list<int> _kernel = { 0, 0, 0, 0, 1, 0, 0, 0, 0 }, int _delta = 0, int _shift = 0) :
+		kernel(), delta(_delta), shift(_shift)
+	{
+		std::copy_n(_kernel.begin(), std::min<std::size_t>(9, _kernel.size()), kernel);
+	}
+	void operator()(cv::Mat& _img) { (*this)(_img, nullptr); }
+	void operator()(cv::Mat& _img, const uchar* _lut)
+	{
+		if (!fvkFastFilters::convolve3x3(_img, _img, kernel, delta, shift, _lut))
+		{
+			// other depths.
+			cv::Mat k, m;
+			cv::Mat(3, 3, CV_32S, kernel).convertTo(k, CV_32F, std::ldexp(1.0, -shift));
+			cv::filter2D(_img, m, _img.depth(), k, cv::Point(-1, -1), delta);
+			_img = m;
+		}
+	}
+	int kernel[9];
+	int delta;
+	int shift;
+};
+
+struct Emboss : Convolution
+{
+	Emboss() : Convolution({ -1, -1, 0, -1, 0, 1, 0, 1, 1 }, 128) {}
+};
+
+struct Dots
+{
+	static const bool is_point = false;
+	explicit Dots(int _level = 0) : level(_level) {}
+	void operator()(cv::Mat& _img) { if (level > 5) halftone.apply(_img, _img, level); }
+	int level;
+	fvkHalftone halftone;
+};
+
+struct GrayScale
+{
+	static const bool is_point = false;
+	GrayScale() {}
+	void operator()(cv::Mat& _img)
+	{
+		cv::Mat m;
+		if (_img.channels() == 3)
+			cv::cvtColor(_img, m, cv::ColorConversionCodes::COLOR_BGR2GRAY);
+		else if (_img.channels() == 4)
+			cv::cvtColor(_img, m, cv::ColorConversionCodes::COLOR_BGRA2GRAY);
+		else
+			return;
+		_img = m;
+	}
+};
+
+struct Threshold
+{
+	static const bool is_point = false;
+	explicit Threshold(int _value = 0) : value(_value) {}
+	void operator()(cv::Mat& _img)
+	{
+		if (value <= 0) return;
+		cv::Mat m = _img;
+		if (_img.channels() == 3)
+			cv::cvtColor(_img, m, CV_BGR2GRAY);
+		else if (_img.channels() == 4)
+			cv::cvtColor(_img, m, CV_BGRA2GRAY);
+		cv::GaussianBlur(m, m, cv::Size(5, 5), 0, 0);
+		cv::threshold(m, m, 255 - value, 255, cv::THRESH_BINARY);
+		_img = m;
+	}
+	int value;
+};
+
+}
+
+// Description:
+// Implementation details of fvkPipeline.
+namespace fvkPipelineDetail
+{
+
+// Description:
+// Index of the first stage from I that is not a point stage (or the number of stages).
+template <typename T, std::size_t I, bool End = (I >= std::tuple_size<T>::value)>
+struct PointRunEnd
+{
+	static const std::size_t value = I;
+};
+template <typename T, std::size_t I>
+struct PointRunEnd<T, I, false>
+{
+	static const std::size_t value = std::tuple_element<I, T>::type::is_point ? PointRunEnd<T, I + 1>::value : I;
+};
+
+// Description:
+// True if the stage T is a table lookup (its table is in T::lut after prepare()).
+template <typename T>
+struct IsLookup : std::integral_constant<bool,
+	std::is_base_of<fvkStages::LookupStage<false>, T>::value || std::is_base_of<fvkStages::LookupStage<true>, T>::value>
+{
+};
+
+// Description:
+// True if the stage T can take the table of the lookup stages before it (T::accepts_lut).
+template <typename T, typename = void>
+struct AcceptsLut : std::false_type
+{
+};
+template <typename T>
+struct AcceptsLut<T, decltype(void(T::accepts_lut))> : std::integral_constant<bool, T::accepts_lut>
+{
+};
+
+// Description:
+// True if the stages from I to End - 1 are all lookup stages.
+template <typename T, std::size_t I, std::size_t End, bool Done = (I >= End)>
+struct AllLookups : std::true_type
+{
+};
+template <typename T, std::size_t I, std::size_t End>
+struct AllLookups<T, I, End, false> : std::integral_constant<bool,
+	IsLookup<typename std::tuple_element<I, T>::type>::value && AllLookups<T, I + 1, End>::value>
+{
+};
+
+// Description:
+// True if the point stages from I to End - 1 can be done by the stage End.
+template <typename T, std::size_t I, std::size_t End, bool Valid = (End < std::tuple_size<T>::value)>
+struct FusesIntoNext : std::false_type
+{
+};
+template <typename T, std::size_t I, std::size_t End>
+struct FusesIntoNext<T, I, End, true> : std::integral_constant<bool,
+	AcceptsLut<typename std::tuple_element<End, T>::type>::value && AllLookups<T, I, End>::value>
+{
+};
+
+// Description:
+// Index sequence from Offset to Offset + sizeof...(K) - 1.
+template <std::size_t Offset, std::size_t... K>
+auto offset(std::index_sequence<K...>) -> std::index_sequence<(Offset + K)...>;
+
+}
+
+template <typename... Stages>
+class fvkPipeline
+{
+public:
+	using Tuple = std::tuple<Stages...>;
+
+	// Description:
+	// Default constructor with the default (inactive) parameters of every stage.
+	fvkPipeline() = default;
+	// Description:
+	// Constructor that takes every stage with its parameters.
+	explicit fvkPipeline(Stages... _stages) : m_stages(std::move(_stages)...) {}
+
+	// Description:
+	// Function to get a reference to a stage, by its index or by its type
+	// (if there is only one stage of that type), e.g. p.stage<fvkStages::Sepia>().value = 30;
+	// The parameters must not be changed while a frame is being processed.
+	template <std::size_t I>
+	auto& stage() { return std::get<I>(m_stages); }
+	template <typename S>
+	auto& stage() { return std::get<S>(m_stages); }
+
+	// Description:
+	// Function that processes the frame with all the stages in their order.
+	void process(cv::Mat& _frame)
+	{
+		if (_frame.empty())
+			return;
+		run<0>(_frame, std::integral_constant<bool, 0 >= sizeof...(Stages)>());
+	}
+	// Description:
+	// Same as process(), so the pipeline can be used as a processing function.
+	void operator()(cv::Mat& _frame) { process(_frame); }
+
+private:
+	template <std::size_t I>
+	using Stage = typename std::tuple_element<I, Tuple>::type;
+
+	template <std::size_t I>
+	void run(cv::Mat&, std::true_type)
+	{
+	}
+	template <std::size_t I>
+	void run(cv::Mat& _frame, std::false_type)
+	{
+		runStage<I>(_frame, std::integral_constant<bool, Stage<I>::is_point>());
+	}
+
+	// Description:
+	// Runs a frame stage and continues with the next one.
+	template <std::size_t I>
+	void runStage(cv::Mat& _frame, std::false_type)
+	{
+		std::get<I>(m_stages)(_frame);
+		run<I + 1>(_frame, std::integral_constant<bool, I + 1 >= sizeof...(Stages)>());
+	}
+	// Description:
+	// Runs all the point stages from I in one loop and continues after them.
+	template <std::size_t I>
+	void runStage(cv::Mat& _frame, std::true_type)
+	{
+		constexpr std::size_t end = fvkPipelineDetail::PointRunEnd<Tuple, I>::value;
+		using Indices = decltype(fvkPipelineDetail::offset<I>(std::make_index_sequence<end - I>()));
+		runPoints<end>(_frame, Indices(), std::integral_constant<bool, fvkPipelineDetail::FusesIntoNext<Tuple, I, end>::value>());
+	}
+
+	// Description:
+	// Runs the point stages K and continues with the stage End.
+	template <std::size_t End, std::size_t... K>
+	void runPoints(cv::Mat& _frame, std::index_sequence<K...> _indices, std::false_type)
+	{
+		fuse(_frame, _indices);
+		run<End>(_frame, std::integral_constant<bool, End >= sizeof...(Stages)>());
+	}
+	// Description:
+	// Gives the composed table of the lookup stages K to the stage End and continues after it.
+	// The color-only tables can not be composed for the alpha channel of a 4 channel image.
+	template <std::size_t End, std::size_t... K>
+	void runPoints(cv::Mat& _frame, std::index_sequence<K...> _indices, std::true_type)
+	{
+		const bool active[] = { std::get<K>(m_stages).active()... };
+		const bool coloronly[] = { std::is_base_of<fvkStages::LookupStage<true>, Stage<K>>::value... };
+		const auto any = std::any_of(std::begin(active), std::end(active), [](bool _b) { return _b; });
+		const auto alpha = _frame.channels() == 4 && std::any_of(std::begin(coloronly), std::end(coloronly), [](bool _b) { return _b; });
+
+		if (!any || _frame.depth() != CV_8U || alpha)
+		{
+			fuse(_frame, _indices);
+			std::get<End>(m_stages)(_frame);
+		}
+		else
+		{
+			const int prepared[] = { (std::get<K>(m_stages).active() ? (std::get<K>(m_stages).prepare(), 0) : 0)... };
+			(void)prepared;
+
+			uchar lut[256];
+			for (auto i = 0; i < 256; i++)
+			{
+				auto v = static_cast<uchar>(i);
+				const int applied[] = { (v = std::get<K>(m_stages).active() ? std::get<K>(m_stages).lut[v] : v, 0)... };
+				(void)applied;
+				lut[i] = v;
+			}
+			std::get<End>(m_stages)(_frame, lut);
+		}
+		run<End + 1>(_frame, std::integral_constant<bool, End + 1 >= sizeof...(Stages)>());
+	}
+
+	template <std::size_t... K>
+	void fuse(cv::Mat& _frame, std::index_sequence<K...>)
+	{
+		if (_frame.depth() != CV_8U)
+			return;
+
+		const bool active[] = { std::get<K>(m_stages).active()... };
+		if (std::none_of(std::begin(active), std::end(active), [](bool _b) { return _b; }))
+			return;
+
+		// every active stage computes its tables once per frame, the inactive ones are skipped.
+		const int prepared[] = { (std::get<K>(m_stages).active() ? (std::get<K>(m_stages).prepare(), 0) : 0)... };
+		(void)prepared;
+
+		switch (_frame.channels())
+		{
+		case 1: fusePixels<1, K...>(_frame, active); break;
+		case 3: fusePixels<3, K...>(_frame, active); break;
+		case 4: fusePixels<4, K...>(_frame, active); break;
+		default: break;
+		}
+	}
+
+	// _active tells which of the stages K are applied.
+	template <int CN, std::size_t... K>
+	void fusePixels(cv::Mat& _frame, const bool* _active)
+	{
+		const auto w = _frame.cols;
+		cv::Mat dst(_frame.size(), _frame.type());
+		cv::parallel_for_(cv::Range(0, _frame.rows), [&](const cv::Range& _range)
+		{
+			for (auto y = _range.start; y < _range.end; y++)
+			{
+				const auto s = _frame.ptr<uchar>(y);
+				auto d = dst.ptr<uchar>(y);
+				for (auto x = 0; x < w; x++)
+				{
+					uchar p[CN];
+					for (auto c = 0; c < CN; c++)
+						p[c] = s[x * CN + c];
+
+					// the active stages are applied in their order on the pixel (kept in registers).
+					auto i = 0;
+					const int applied[] = { (_active[i++] ? (std::get<K>(m_stages).template apply<CN>(p), 0) : 0)... };
+					(void)applied;
+
+					for (auto c = 0; c < CN; c++)
+						d[x * CN + c] = p[c];
+				}
+			}
+		});
+		_frame = dst;
+	}
+
+	Tuple m_stages;
+};
+
+}
+
+#endif // fvkPipeline_h__
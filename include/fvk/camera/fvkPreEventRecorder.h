@@ -0,0 +1,220 @@
+#pragma once
+#ifndef fvkPreEventRecorder_h__
+#define fvkPreEventRecorder_h__
+
+/*********************************************************************************
+created:	2026/10/23   05:20PM
+filename: 	fvkPreEventRecorder.h
+file base:	fvkPreEventRecorder
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that keeps the last seconds of a camera in memory as JPEG
+images, within a memory budget, and writes them to a video file when an event
+is triggered, followed by the live frames of the post-roll. The compression is
+done by a thread of the recorder and the writing by another one, so addFrame never
+waits and the frames that come during the writing of an event are kept.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkVideoWriter.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <vector>
+#include <string>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkPreEventStats
+{
+public:
+	fvkPreEventStats() :
+		frames(0),
+		dropped(0),
+		buffered(0),
+		memory(0),
+		seconds(0),
+		events(0),
+		recording(false),
+		writing(0),
+		compress_time(0)
+	{
+	}
+	long long frames;		// number of frames given to addFrame.
+	long long dropped;		// frames dropped because a thread of the recorder was behind.
+	int buffered;			// number of frames in the pre-roll.
+	std::size_t memory;		// bytes of the compressed frames in the pre-roll.
+	double seconds;			// duration of the pre-roll in seconds.
+	int events;				// number of written event files.
+	bool recording;			// true while the frames are sent to an event file.
+	int writing;			// frames waiting to be written to the event file.
+	double compress_time;	// average time to compress a frame in milliseconds.
+};
+
+class FVK_CAMERA_EXPORT fvkPreEventRecorder
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkPreEventRecorder();
+	// Description:
+	// Destructor that stops the recorder.
+	~fvkPreEventRecorder();
+
+	// Description:
+	// Function to start keeping the frames given to addFrame.
+	void start();
+	// Description:
+	// Function to stop the recorder. An event file being written is closed
+	// with the frames received so far, and the pre-roll is released.
+	void stop();
+	// Description:
+	// Function that returns true if the recorder is started.
+	auto isActive() const -> bool;
+
+	// Description:
+	// Function to add a new frame. It does not block: the frame is queued without a copy
+	// for the thread of the recorder, so its pixels must not be modified after this call.
+	// If the thread is behind by more than a few frames, the frame is dropped.
+	void addFrame(const cv::Mat& _frame);
+
+	// Description:
+	// Function to write the pre-roll and the next post-roll seconds to a video file.
+	// If _filename is empty, the file is "event_<date>_<time>" in the output folder.
+	// If an event is already being written, its post-roll is extended instead.
+	// It returns false if the recorder is not started.
+	auto trigger(const std::string& _filename = std::string()) -> bool;
+
+	// Description:
+	// Function to set the seconds kept before an event.
+	// Default value is 5.
+	void setPreRoll(double _seconds);
+	// Description:
+	// Function to get the seconds kept before an event.
+	auto getPreRoll() const -> double;
+	// Description:
+	// Function to set the seconds written after an event.
+	// Default value is 10.
+	void setPostRoll(double _seconds);
+	// Description:
+	// Function to get the seconds written after an event.
+	auto getPostRoll() const -> double;
+	// Description:
+	// Function to set the maximum bytes of the compressed pre-roll.
+	// The oldest frames are released first, so the pre-roll can be shorter than setPreRoll.
+	// Default value is 64 MB.
+	void setMemoryBudget(std::size_t _bytes);
+	// Description:
+	// Function to get the maximum bytes of the compressed pre-roll.
+	auto getMemoryBudget() const -> std::size_t;
+	// Description:
+	// Function to set the JPEG quality of the pre-roll (1 to 100).
+	// Default value is 90.
+	void setQuality(int _value);
+	// Description:
+	// Function to get the JPEG quality of the pre-roll.
+	auto getQuality() const -> int;
+	// Description:
+	// Function to set the folder of the event files.
+	void setOutputFolder(const std::string& _folder);
+	// Description:
+	// Function to get the folder of the event files.
+	auto getOutputFolder() const -> std::string;
+	// Description:
+	// Function to set the extension of the event files.
+	// Default value is ".avi".
+	void setFileExtension(const std::string& _ext);
+	// Description:
+	// Function to get the extension of the event files.
+	auto getFileExtension() const -> std::string;
+
+	// Description:
+	// Function to get a reference to the video writer of the event files, to set
+	// its codec, fps and api before the recorder is started. Its output location
+	// and its size are set by the recorder for every event. It is only used by the
+	// writing thread of the recorder, so its backlog policy can stay BacklogPolicy::Block.
+	auto& writer() { return m_writer; }
+
+	// Description:
+	// Function to get the statistics of the recorder.
+	auto getStats() const -> fvkPreEventStats;
+
+private:
+	// Description:
+	// One compressed frame of the pre-roll.
+	struct Packet
+	{
+		std::shared_ptr<const std::vector<uchar>> data;		// shared with the writing thread.
+		int64 tick;
+	};
+	// Description:
+	// One frame waiting for the thread of the recorder.
+	struct Frame
+	{
+		cv::Mat image;
+		int64 tick;
+	};
+
+	// Description:
+	// One command of the writing thread: open an event file, write a frame
+	// (raw or compressed), or close the file.
+	struct Item
+	{
+		std::string file;
+		cv::Mat image;
+		std::shared_ptr<const std::vector<uchar>> data;
+		bool close;
+	};
+
+	void run();
+	void write();
+	void post(Item _item, bool _live, std::size_t _budget);
+	auto open(const std::string& _filename, const cv::Mat& _frame) -> bool;
+	void close();
+
+	std::thread m_thread;
+	std::thread m_writethread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::condition_variable m_writecond;
+	bool m_active;
+	bool m_stop;
+	bool m_writestop;
+
+	std::deque<Item> m_items;			// commands of the writing thread.
+	std::size_t m_itembytes;			// bytes of the frames in m_items.
+	int m_itemraw;						// raw frames in m_items.
+
+	std::deque<Frame> m_pending;
+	std::vector<std::string> m_triggers;	// file names of the triggered events.
+	std::deque<Packet> m_ring;			// the pre-roll (used by the thread of the recorder).
+	int64 m_until;						// tick count of the end of the post-roll (same).
+	bool m_recording;					// an event file is written (same).
+
+	double m_preroll;
+	double m_postroll;
+	std::size_t m_budget;
+	int m_quality;
+	std::string m_folder;
+	std::string m_ext;
+	fvkVideoWriter m_writer;
+	fvkPreEventStats m_stats;
+};
+
+}
+
+#endif // fvkPreEventRecorder_h__
@@ -0,0 +1,128 @@
+#pragma once
+#ifndef fvkProcessingPool_h__
+#define fvkProcessingPool_h__
+
+/*********************************************************************************
+created:	2026/10/20   09:15AM
+filename: 	fvkProcessingPool.h
+file base:	fvkProcessingPool
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that filters consecutive frames concurrently on several worker
+threads and gives them back in their original order.
+Every worker has its own fvkImageProcessing whose settings follow the settings
+of the processing thread.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkImageProcessing.h"
+
+#include <thread>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkProcessingPool
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkProcessingPool();
+	// Description:
+	// Destructor that stops the workers.
+	~fvkProcessingPool();
+
+	// Description:
+	// Function to start _workers worker threads and one output thread.
+	// _settings is the image processing object whose settings are copied by the workers
+	// whenever they change (see fvkImageProcessing::getSettingsRevision).
+	// _output is called for every processed frame, in the order of submission,
+	// always from the output thread.
+	// _processed (optional) is called by the output thread right before _output, in the same
+	// order, with the stage times of the frame (not for repeated frames): the times given
+	// to submit for the pre-processing stages and the times of the worker for the others.
+	void start(int _workers, fvkImageProcessing* _settings, std::function<void(cv::Mat&)> _output, std::function<void(const std::vector<double>&)> _processed = nullptr);
+	// Description:
+	// Function that waits until all the submitted frames are given to the output function,
+	// and then stops the threads.
+	void stop();
+	// Description:
+	// Function that returns true if the threads are running.
+	auto active() const -> bool;
+	// Description:
+	// Function to get the number of worker threads.
+	auto getWorkerCount() const -> int;
+	// Description:
+	// Function to get the number of frames whose filtering threw an exception since start.
+	// Such a frame is given to the output function as it was submitted.
+	auto getFailedCount() const -> long long;
+
+	// Description:
+	// Function to submit the next frame, already pre-processed by fvkImageProcessing::preProcessing.
+	// _face is the face rectangle that was returned by preProcessing, and _faces and _times
+	// the faces and the stage times given by fvkImageProcessing::getTrackedFaces and
+	// getStageTimes right after it.
+	// The workers run fvkImageProcessing::filterProcessing and postProcessing on it.
+	// It blocks while twice the number of workers frames are being processed, so the
+	// capture buffer drops the frames that can not be processed in time, as before.
+	void submit(const cv::Mat& _frame, const cv::Rect& _face, const std::vector<fvkTrackedFace>& _faces = std::vector<fvkTrackedFace>(), const std::vector<double>& _times = std::vector<double>());
+	// Description:
+	// Function to submit a frame that is the same as the previous one (see fvkMotionGate).
+	// The previous output frame is given to the output function again, in its turn.
+	void repeat();
+
+private:
+	struct Job
+	{
+		unsigned long long seq;
+		cv::Mat frame;
+		cv::Rect face;
+		bool repeat;
+		std::vector<fvkTrackedFace> faces;
+		std::vector<double> times;	// stage times of the pre-processing, then of the frame.
+	};
+
+	void work(int _index);
+	void output();
+
+	std::vector<std::thread> m_workers;
+	std::vector<std::unique_ptr<fvkImageProcessing>> m_ips;
+	std::thread m_output_thread;
+	fvkImageProcessing* p_settings;
+	std::function<void(cv::Mat&)> m_output;
+	std::function<void(const std::vector<double>&)> m_processed;
+
+	std::deque<Job> m_jobs;							// frames waiting for a worker.
+	std::map<unsigned long long, Job> m_done;		// processed frames waiting for their turn.
+	cv::Mat m_last;									// last output frame (for repeated frames).
+	unsigned long long m_submitted;					// sequence number of the next submitted frame.
+	unsigned long long m_emitted;					// sequence number of the next output frame.
+	long long m_failed;								// frames whose filtering threw an exception.
+
+	mutable std::mutex m_mutex;
+	std::condition_variable m_jobcond;
+	std::condition_variable m_donecond;
+	std::condition_variable m_spacecond;
+	bool m_stop;
+	bool m_active;
+};
+
+}
+
+#endif // fvkProcessingPool_h__
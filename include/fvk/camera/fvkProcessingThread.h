@@ -25,8 +25,12 @@ camera frame. This thread is synchronized with the camera thread using a semapho
 **********************************************************************************/
 
 #include "fvkImageProcessing.h"
+#include "fvkProcessingPool.h"
+#include "fvkQualityGovernor.h"
+#include "fvkMotionGate.h"
 #include "fvkSemaphoreBuffer.h"
 #include "fvkVideoWriter.h"
+#include "fvkPreEventRecorder.h"
 #include "fvkThread.h"
 
 namespace R3D
@@ -101,11 +105,47 @@ public:
 	// Description:
 	// Function to get a reference to video writer.
 	auto& writer() { return m_vr; }
+	// Description:
+	// Function to get a reference to the pre-event recorder (call its start() to keep the last seconds).
+	auto& preEventRecorder() { return m_per; }
 
 	// Description:
 	// Function to get a reference to image processing.
 	auto& imageProcessing() { return m_ip; }
 
+	// Description:
+	// Function to set a function that processes the frames instead of imageProcessing(),
+	// for example a fvkPipeline with a fixed chain of filters (see fvkPipeline.h).
+	// The frames are processed on this thread (the processing workers, the quality governor and
+	// the settings of imageProcessing() are not used). Set nullptr to use imageProcessing() again.
+	// It should be set before the thread is started.
+	void setProcessingFunction(const std::function<void(cv::Mat&)> _f);
+
+	// Description:
+	// Function to get a reference to the quality governor, which lowers the quality of the
+	// expensive filters when the processing can not keep up with the camera (disabled by default).
+	auto& governor() { return m_governor; }
+
+	// Description:
+	// Function to get a reference to the motion gate. When it is enabled, the frames that
+	// have not changed since the last processed frame are not processed, and the last
+	// processed frame is given to present(), the video output function and the video writer
+	// again (disabled by default).
+	auto& motionGate() { return m_gate; }
+
+	// Description:
+	// Function to set the number of worker threads that filter consecutive frames concurrently.
+	// With more than one worker, this thread only does the geometric transform and the
+	// face tracking (which depend on the previous frames) in the capture order, and the
+	// processed frames are given to present(), the video output function and the
+	// video writer in their capture order from a separate output thread.
+	// It is useful when heavy filters (e.g. stylization or NL means) are enabled.
+	// Default value is 1 (no worker threads).
+	void setProcessingWorkers(const int _n);
+	// Description:
+	// Function to get the number of worker threads.
+	auto getProcessingWorkers() const -> int;
+
 protected:
 	// Description:
 	// Overridden function to process the camera frame.
@@ -116,6 +156,11 @@ protected:
 	// to process the captured frame.
 	virtual void present(cv::Mat& _frame);
 
+	// Description:
+	// Function that gives the processed frame to the observer, present(), the video
+	// output function, the snapshot and the video writer.
+	void output(cv::Mat& _frame);
+
 	// Description:
 	// Function that saves the current frame to disk (file path must be specified by setSavedFile("")).
 	auto saveFrameToDisk(const cv::Mat& _frame) -> bool;
@@ -126,9 +171,17 @@ protected:
 	std::mutex m_processing_mutex;
 	fvkSemaphoreBuffer<cv::Mat> *p_buffer;
 	std::function<void(cv::Mat&, const fvkThreadStats&)> m_video_output_func;
+	std::function<void(cv::Mat&)> m_processing_func;
 
 	fvkImageProcessing m_ip;
 	fvkVideoWriter m_vr;
+	fvkPreEventRecorder m_per;
+	fvkProcessingPool m_pool;
+	fvkQualityGovernor m_governor;
+	fvkMotionGate m_gate;
+	fvkFramePyramid m_pyramid;	// downscaled copies of the current frame.
+	cv::Mat m_last;		// last processed frame (for the static frames).
+	std::atomic<int> m_nworkers;
 
 	int m_device_index;
 	std::string m_filepath;
@@ -0,0 +1,164 @@
+#pragma once
+#ifndef fvkQualityGovernor_h__
+#define fvkQualityGovernor_h__
+
+/*********************************************************************************
+created:	2026/10/20   11:30AM
+filename: 	fvkQualityGovernor.h
+file base:	fvkQualityGovernor
+file ext:	h
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that keeps the processing of a camera within its frame budget.
+It measures the cost of every image processing stage against the frame period,
+lowers the quality of the most expensive stages when the processing falls behind
+and restores them (last lowered first) when there is enough headroom again.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include "fvkImageProcessing.h"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace R3D
+{
+
+class FVK_CAMERA_EXPORT fvkQualityStats
+{
+public:
+	fvkQualityStats() :
+		budget(0),
+		cost(0),
+		load(0),
+		level(0),
+		reductions(0),
+		restorations(0)
+	{
+	}
+	double budget;			// frame budget in milliseconds.
+	double cost;			// smoothed processing time per frame in milliseconds.
+	double load;			// cost relative to the budget (of the busiest thread when the frames are processed concurrently).
+	int level;				// number of quality reductions currently applied.
+	int reductions;			// total number of quality reductions.
+	int restorations;		// total number of restorations.
+	std::string decision;	// description of the last decision.
+	std::vector<double> stages;						// smoothed time of every stage (indexed by fvkImageProcessing::Stage).
+	fvkImageProcessing::QualityReduction reduction;	// quality reductions currently applied.
+};
+
+class FVK_CAMERA_EXPORT fvkQualityGovernor
+{
+public:
+	// Description:
+	// Default constructor.
+	fvkQualityGovernor();
+
+	// Description:
+	// Function to turn the governor ON/OFF.
+	// Turning it OFF removes all the quality reductions at the next frame.
+	// Default value is false.
+	void setEnabled(bool _value);
+	// Description:
+	// Function that returns true if the governor is enabled.
+	auto isEnabled() const -> bool;
+
+	// Description:
+	// Function to set the frame budget (the frame period of the camera) in milliseconds.
+	// fvkCamera sets it to the delay of the camera thread when it is not specified.
+	// Default value is 0 (the governor does nothing).
+	void setFrameBudget(double _msec);
+	// Description:
+	// Function to get the frame budget in milliseconds.
+	auto getFrameBudget() const -> double;
+
+	// Description:
+	// Function to set the load thresholds (processing time relative to the frame budget).
+	// The quality is lowered when the load stays above _high, and restored when it stays below
+	// _low and the restored stage is expected to keep it below _high.
+	// Default values are 0.6 and 0.9.
+	void setLoadThresholds(double _low, double _high);
+
+	// Description:
+	// Function to be called after every processed frame.
+	// _ip is the image processing object whose settings are governed.
+	// _stage_times are the times of the stages of that frame (see fvkImageProcessing::getStageTimes).
+	// _workers is the number of threads that filter the frames concurrently (the geometric
+	// transform and the face detection are always done by one thread).
+	// The settings of _ip are read before the lock of the governor is taken, so the two locks
+	// are never nested. It must be called by one thread, in the order of the frames.
+	// It returns true if the quality reductions have changed, in which case they must be
+	// given to _ip with fvkImageProcessing::setQualityReduction(getQualityReduction()).
+	auto update(fvkImageProcessing& _ip, const std::vector<double>& _stage_times, int _workers = 1) -> bool;
+
+	// Description:
+	// Function to get the quality reductions that are currently decided.
+	auto getQualityReduction() const -> fvkImageProcessing::QualityReduction;
+	// Description:
+	// Function to get the measurements and the decisions of the governor.
+	auto getStats() const -> fvkQualityStats;
+
+private:
+	// Description:
+	// Quality knobs in the order they are preferred when their stages cost the same.
+	enum class Knob
+	{
+		NonPhotorealistic = 0,
+		Denoising,
+		FaceDetection,
+		ProcessingScale
+	};
+	// Description:
+	// One applied reduction; the reductions are restored in the reverse order.
+	struct Step
+	{
+		Knob knob;
+		fvkImageProcessing::QualityReduction previous;
+		double load_before;		// load when the reduction was applied.
+		double load_after;		// load measured after the cool down (< 0 until then).
+	};
+
+	// Description:
+	// The governed settings of the image processing, read by update.
+	struct Settings
+	{
+		fvkImageProcessing::FilterQuality npr_quality;
+		int denoising_level;
+		bool face_detection;
+	};
+
+	// Description:
+	// Lowers the quality of the most expensive stage on the busiest thread.
+	// It returns false if there is nothing left to lower.
+	auto reduce(const Settings& _settings, bool _filters, bool _faces) -> bool;
+	// Description:
+	// Function that returns the smoothed time of the given stages.
+	auto cost(fvkImageProcessing::Stage _first, fvkImageProcessing::Stage _last) const -> double;
+
+	mutable std::mutex m_mutex;
+	bool m_enabled;
+	double m_budget;
+	double m_low;
+	double m_high;
+	std::vector<double> m_times;		// smoothed stage times.
+	std::vector<Step> m_steps;
+	fvkImageProcessing::QualityReduction m_reduction;
+	fvkQualityStats m_stats;
+	int m_over;			// consecutive frames above the high threshold.
+	int m_under;		// consecutive frames below the low threshold.
+	int m_cooldown;		// frames to wait until the effect of the last decision is measured.
+};
+
+}
+
+#endif // fvkQualityGovernor_h__
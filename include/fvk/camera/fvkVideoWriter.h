@@ -13,6 +13,10 @@ website:    http://real3d.pk
 CopyRight:	All Rights Reserved
 
 purpose:	Thread safe class to create a video file using OpenCV video writer.
+The frames are encoded by a thread of the writer, so addFrame does not wait for
+the encoder. They are queued without a copy, and the backlog is either bounded
+(block or drop) or allowed to grow up to a memory cap. A long recording can be
+split in segments, switched by the encoder thread without losing a frame.
 
 /**********************************************************************************
 *	Fast Visualization Kit (FVK)
@@ -27,13 +31,74 @@ purpose:	Thread safe class to create a video file using OpenCV video writer.
 
 #include "opencv2/opencv.hpp"
 
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <functional>
+
 namespace R3D
 {
 
+class FVK_CAMERA_EXPORT fvkVideoWriterStats
+{
+public:
+	fvkVideoWriterStats() :
+		frames(0),
+		written(0),
+		dropped(0),
+		backlog(0),
+		peak_backlog(0),
+		memory(0),
+		encode_time(0),
+		max_encode_time(0),
+		blocked_time(0),
+		segments(0)
+	{
+	}
+	long long frames;			// number of frames given to addFrame since the video was opened.
+	long long written;			// number of encoded frames.
+	long long dropped;			// number of frames dropped by the backlog policy.
+	int backlog;				// number of frames waiting for the encoder (including the ones being encoded).
+	int peak_backlog;			// highest backlog since the video was opened.
+	std::size_t memory;			// bytes of the frames waiting for the encoder.
+	double encode_time;			// average time to encode a frame in milliseconds.
+	double max_encode_time;		// longest time to encode a frame in milliseconds.
+	double blocked_time;		// total time addFrame waited for the encoder in milliseconds.
+	int segments;				// number of closed segments.
+};
+
+class FVK_CAMERA_EXPORT fvkVideoSegment
+{
+public:
+	fvkVideoSegment() :
+		index(0),
+		frames(0),
+		duration(0),
+		bytes(0)
+	{
+	}
+	int index;					// number of the segment, from 1.
+	std::string file;			// path of the segment file.
+	long long frames;			// number of frames in the segment.
+	double duration;			// duration of the segment in seconds (frames / fps).
+	std::size_t bytes;			// size of the file.
+};
+
 class FVK_CAMERA_EXPORT fvkVideoWriter
 {
 
 public:
+	// Description:
+	// What addFrame does when the encoder is behind.
+	enum class BacklogPolicy
+	{
+		Block,		// wait until the backlog is below the maximum number of frames.
+		Drop,		// drop the new frame if the backlog is at the maximum number of frames.
+		Grow		// keep every frame until the backlog reaches the maximum memory, then drop.
+	};
+
 	fvkVideoWriter();
 	virtual ~fvkVideoWriter();
 
@@ -79,13 +144,72 @@ public:
 
 	// Description:
 	// Function to add a new image frame to the video file.
+	// The frame is queued for the encoder thread without a copy, so its pixels
+	// must not be modified after this call (a new frame must use a new buffer).
 	void addFrame(const cv::Mat& _frame);
 
+	// Description:
+	// Function that waits until all the queued frames are encoded.
+	void flush();
+
 	// Description:
 	// Function that stops video recoding and finalize the video file.
+	// The queued frames are encoded before the file is closed.
 	// Without calling this function, video file won't be played.
 	void stop();
 
+	// Description:
+	// Function to set what addFrame does when the encoder is behind.
+	// Default value is BacklogPolicy::Block.
+	void setBacklogPolicy(BacklogPolicy _policy);
+	// Description:
+	// Function to get what addFrame does when the encoder is behind.
+	auto getBacklogPolicy() const -> BacklogPolicy;
+	// Description:
+	// Function to set the maximum number of frames waiting for the encoder
+	// with the Block and Drop policies.
+	// Default value is 8.
+	void setMaxBacklog(int _frames);
+	// Description:
+	// Function to get the maximum number of frames waiting for the encoder.
+	auto getMaxBacklog() const -> int;
+	// Description:
+	// Function to set the maximum bytes of the frames waiting for the encoder
+	// with the Grow policy.
+	// Default value is 512 MB.
+	void setMaxBacklogMemory(std::size_t _bytes);
+	// Description:
+	// Function to get the maximum bytes of the frames waiting for the encoder.
+	auto getMaxBacklogMemory() const -> std::size_t;
+
+	// Description:
+	// Function to get the backlog and the encoding statistics of the current video.
+	auto getStats() const -> fvkVideoWriterStats;
+
+	// Description:
+	// Function to start a new file every _seconds of video (frames / fps), 0 = no limit.
+	// With a limit of duration or of size, the files are named after the output location
+	// with the number of the segment before the extension, e.g. "video_0001.mp4".
+	// The next file is opened in the background, and the encoder thread switches to it
+	// between two frames, so no frame is lost and addFrame does not wait.
+	// It must be set before open(). Default value is 0.
+	void setSegmentDuration(double _seconds) { m_segmentduration = _seconds; }
+	// Description:
+	// Function to get the duration of the segments in seconds.
+	auto getSegmentDuration() const { return m_segmentduration; }
+	// Description:
+	// Function to start a new file when the current one reaches about _bytes, 0 = no limit.
+	// The size is the one on the disk, so it lags behind by the data buffered by the encoder.
+	// It must be set before open(). Default value is 0.
+	void setSegmentSize(std::size_t _bytes) { m_segmentsize = _bytes; }
+	// Description:
+	// Function to get the size of the segments in bytes.
+	auto getSegmentSize() const { return m_segmentsize; }
+	// Description:
+	// Function to set a function that is called with every closed file (a segment, or the whole
+	// video without a segment limit), on a thread of the writer. It must be set before open().
+	void setSegmentFunction(const std::function<void(const fvkVideoSegment&)> _f) { m_segment_func = _f; }
+
 	// Description:
 	// Function to set the api preference.
 	// The _api parameter allows to specify API backends to use.
@@ -152,7 +276,32 @@ public:
 	auto getCodec() const { return m_codec; }
 
 private:
-	cv::VideoWriter m_writer;
+	void run();
+	auto isSegmented() const -> bool;
+	auto segmentFile(int _index) const -> std::string;
+	auto openFile(const std::string& _file) const -> std::unique_ptr<cv::VideoWriter>;
+	void rotate();
+	void closed(fvkVideoSegment& _segment);
+
+	std::unique_ptr<cv::VideoWriter> m_writer;	// used by the encoder thread while the video is opened.
+	std::unique_ptr<cv::VideoWriter> m_next;	// next segment, opened by m_opener.
+	std::thread m_opener;						// closes the last segment and opens the next one.
+	fvkVideoSegment m_segment;					// current segment.
+	bool m_rotate;								// false if the next segment could not be opened.
+	int m_fourcc;
+	std::thread m_thread;
+	mutable std::mutex m_mutex;
+	std::condition_variable m_cond;
+	std::condition_variable m_space;
+	std::deque<cv::Mat> m_queue;	// frames not yet taken by the encoder thread.
+	bool m_open;
+	bool m_stop;
+	BacklogPolicy m_policy;
+	int m_maxbacklog;
+	std::size_t m_maxmemory;
+	double m_totalencode;
+	fvkVideoWriterStats m_stats;
+
 	int m_api;
 	std::string m_file;
 	cv::Size m_size;
@@ -160,6 +309,9 @@ private:
 	bool m_iscolor;
 	bool m_autocodec;
 	std::string m_codec;
+	double m_segmentduration;
+	std::size_t m_segmentsize;
+	std::function<void(const fvkVideoSegment&)> m_segment_func;
 };
 
 }
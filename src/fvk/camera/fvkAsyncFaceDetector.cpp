@@ -0,0 +1,277 @@
+/*********************************************************************************
+created:	2026/10/21   02:40PM
+filename: 	fvkAsyncFaceDetector.cpp
+file base:	fvkAsyncFaceDetector
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that runs the face detector on its own thread, so the cascade
+does not stall the processing of the frames. The frames are downscaled by the
+caller and handed over without blocking (only the latest one is kept), and the
+results come back tagged with the sequence number of their frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkAsyncFaceDetector.h>
+#include <fvk/camera/fvkFaceDetectionService.h>
+
+#include <algorithm>
+
+using namespace R3D;
+
+fvkAsyncFaceDetector::fvkAsyncFaceDetector() :
+m_stop(false),
+m_pending_scale(0),
+m_pending_seq(0),
+m_has_pending(false),
+m_reset(false),
+m_width(320),
+m_extrapolate(true),
+m_service(nullptr),
+m_client(0),
+m_priority(0)
+{
+}
+
+fvkAsyncFaceDetector::~fvkAsyncFaceDetector()
+{
+	setService(nullptr);
+	stop();
+}
+
+auto fvkAsyncFaceDetector::loadCascadeClassifier(const std::string& _filename) -> bool
+{
+	// the detector is only used by the detection thread, so it is stopped while loading.
+	stop();
+	reset();
+	return m_fd.setFaceCascade(_filename);
+}
+
+auto fvkAsyncFaceDetector::loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool
+{
+	stop();
+	reset();
+	return m_fd.setBackend(_type, _filename);
+}
+
+void fvkAsyncFaceDetector::setResizedWidth(int _width)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_width = std::max(_width, 1);
+}
+auto fvkAsyncFaceDetector::getResizedWidth() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_width;
+}
+
+void fvkAsyncFaceDetector::setExtrapolation(bool _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_extrapolate = _value;
+}
+auto fvkAsyncFaceDetector::isExtrapolation() const -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_extrapolate;
+}
+
+void fvkAsyncFaceDetector::submit(const cv::Mat& _frame, unsigned long long _seq)
+{
+	fvkFramePyramid pyramid(_frame);
+	submit(pyramid, _seq);
+}
+
+void fvkAsyncFaceDetector::submit(fvkFramePyramid& _pyramid, unsigned long long _seq)
+{
+	int width;
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		width = m_width;
+	}
+
+	// the small copy is made here, so the caller can keep using its frame.
+	// The pyramid does not reuse its copies, so the detection thread can read it.
+	cv::Mat resized;
+	const auto scale = fvkFaceDetector::downscale(_pyramid, resized, width);
+	if (scale <= 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		if (m_service)
+		{
+			m_service->submit(m_client, resized, scale, _pyramid.frame().size(), _seq, m_reset);
+			m_reset = false;
+			return;
+		}
+
+		m_pending = resized;
+		m_pending_scale = scale;
+		m_pending_size = _pyramid.frame().size();
+		m_pending_seq = _seq;
+		m_has_pending = true;
+
+		if (!m_thread.joinable())
+		{
+			m_stop = false;
+			m_thread = std::thread([this]() { run(); });
+		}
+	}
+	m_cond.notify_one();
+}
+
+auto fvkAsyncFaceDetector::getResult() const -> fvkFaceResult
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_last;
+}
+
+auto fvkAsyncFaceDetector::getRect(unsigned long long _seq) const -> cv::Rect
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	if (!m_last.found)
+		return cv::Rect();
+
+	auto r = m_last.rect;
+	if (m_extrapolate && m_previous.found && m_previous.frame_size == m_last.frame_size &&
+		m_last.seq > m_previous.seq && _seq > m_last.seq)
+	{
+		// constant velocity, but never further ahead than the interval it was measured over.
+		const auto span = m_last.seq - m_previous.seq;
+		const auto f = static_cast<double>(std::min(_seq - m_last.seq, span)) / static_cast<double>(span);
+		r.x += cvRound((m_last.rect.x - m_previous.rect.x) * f);
+		r.y += cvRound((m_last.rect.y - m_previous.rect.y) * f);
+		r &= cv::Rect(cv::Point(0, 0), m_last.frame_size);
+	}
+	return r;
+}
+
+void fvkAsyncFaceDetector::setService(fvkFaceDetectionService* _service)
+{
+	stop();
+
+	// the old service is left outside the lock, because it waits for a result that takes it.
+	fvkFaceDetectionService* old;
+	int client;
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		old = m_service;
+		client = m_client;
+		m_service = nullptr;
+	}
+	if (old)
+		old->disconnect(client);
+
+	reset();
+	if (!_service)
+		return;
+
+	const auto id = _service->connect([this](const fvkFaceResult& _result) { result(_result); });
+	std::lock_guard<std::mutex> locker(m_mutex);
+	_service->setPriority(id, m_priority);
+	m_service = _service;
+	m_client = id;
+}
+auto fvkAsyncFaceDetector::getService() const -> fvkFaceDetectionService*
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_service;
+}
+
+void fvkAsyncFaceDetector::setServicePriority(int _priority)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_priority = _priority;
+	if (m_service)
+		m_service->setPriority(m_client, _priority);
+}
+auto fvkAsyncFaceDetector::getServicePriority() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_priority;
+}
+
+void fvkAsyncFaceDetector::result(const fvkFaceResult& _result)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	if (m_reset)
+		return;		// reset during the detection, the result is for the old face.
+	m_previous = m_last;
+	m_last = _result;
+}
+
+void fvkAsyncFaceDetector::reset()
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_pending.release();
+	m_has_pending = false;
+	m_reset = true;
+	m_last = fvkFaceResult();
+	m_previous = fvkFaceResult();
+}
+
+void fvkAsyncFaceDetector::stop()
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_stop = true;
+	}
+	m_cond.notify_all();
+	if (m_thread.joinable())
+		m_thread.join();
+}
+
+void fvkAsyncFaceDetector::run()
+{
+	while (true)
+	{
+		cv::Mat frame;
+		double scale;
+		cv::Size size;
+		unsigned long long seq;
+		bool reset;
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			m_cond.wait(lk, [this]() { return m_stop || m_has_pending; });
+			if (m_stop)
+				return;
+			frame = m_pending;
+			m_pending.release();
+			m_has_pending = false;
+			scale = m_pending_scale;
+			size = m_pending_size;
+			seq = m_pending_seq;
+			reset = m_reset;
+			m_reset = false;
+		}
+
+		if (reset)
+			m_fd.reset();
+
+		const auto t = cv::getTickCount();
+		m_fd.detectResized(frame, scale);
+
+		fvkFaceResult r;
+		r.rect = m_fd.getRect();
+		r.frame_size = size;
+		r.seq = seq;
+		r.found = m_fd.isFaceFound();
+		r.duration = static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency();
+
+		std::lock_guard<std::mutex> lk(m_mutex);
+		if (m_reset)
+			continue;	// reset during the detection, the result is for the old face.
+		m_previous = m_last;
+		m_last = r;
+	}
+}
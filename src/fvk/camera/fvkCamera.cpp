@@ -136,6 +136,7 @@ auto fvkCamera::disconnect() -> bool
 		{
 			p_pt->stop();
 			p_pt->writer().stop();
+			p_pt->preEventRecorder().stop();
 			std::cout << "[" << p_pt->getDeviceIndex() << "] camera processing thread has been stopped successfully.\n";
 		}
 	}
@@ -188,6 +189,10 @@ auto fvkCamera::start() -> bool
 #endif // _WIN32
 	p_stdct->detach();
 
+	// the frame budget of the quality governor is the frame period of the camera thread.
+	if (p_pt->governor().getFrameBudget() <= 0)
+		p_pt->governor().setFrameBudget(p_ct->getDelay());
+
 	if (p_stdpt)
 		delete p_stdpt;
 	p_stdpt = new std::thread([&]() { p_pt->start(); });
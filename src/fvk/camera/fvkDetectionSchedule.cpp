@@ -0,0 +1,170 @@
+/*********************************************************************************
+created:	2026/10/22   10:05AM
+filename: 	fvkDetectionSchedule.cpp
+file base:	fvkDetectionSchedule
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that decides on which frames the face detection runs.
+The detection runs at once on a scene change or when the face is lost, and
+its interval doubles (up to a maximum) while the face and the scene are stable.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkDetectionSchedule.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace R3D;
+
+static const int THUMBNAIL_WIDTH = 96;	// width of the thumbnails (the same as fvkMotionGate).
+
+fvkDetectionSchedule::fvkDetectionSchedule() :
+m_adaptive(true),
+m_max(60),
+m_stable(2),
+m_scene(20),
+m_period(0),
+m_base(1),
+m_count(0),
+m_immediate(true),
+m_found(false),
+m_fixed(0),
+m_start(0)
+{
+}
+
+void fvkDetectionSchedule::setAdaptive(bool _value)
+{
+	m_adaptive = _value;
+	m_period = 0;
+}
+auto fvkDetectionSchedule::isAdaptive() const -> bool
+{
+	return m_adaptive;
+}
+
+void fvkDetectionSchedule::setMaxInterval(int _frames)
+{
+	m_max = std::max(_frames, 1);
+}
+auto fvkDetectionSchedule::getMaxInterval() const -> int
+{
+	return m_max;
+}
+
+void fvkDetectionSchedule::setThresholds(double _stable, double _scene)
+{
+	m_stable = _stable;
+	m_scene = _scene;
+}
+
+auto fvkDetectionSchedule::getStats() const -> fvkDetectionScheduleStats
+{
+	return m_stats;
+}
+
+void fvkDetectionSchedule::reset()
+{
+	m_prev.release();
+	m_period = 0;
+	m_count = 0;
+	m_immediate = true;
+	m_found = false;
+	m_fixed = 0;
+	m_start = 0;
+	m_stats = fvkDetectionScheduleStats();
+}
+
+auto fvkDetectionSchedule::next(const cv::Mat& _frame, int _frame_delay) -> bool
+{
+	fvkFramePyramid pyramid(_frame);
+	return next(pyramid, _frame_delay);
+}
+
+auto fvkDetectionSchedule::next(fvkFramePyramid& _pyramid, int _frame_delay) -> bool
+{
+	if (m_start == 0)
+		m_start = cv::getTickCount();
+
+	// the fixed schedule detects every (_frame_delay + 1) frames.
+	m_base = std::max(1, _frame_delay + 1);
+	m_fixed += 1.0 / m_base;
+	m_stats.frames++;
+
+	auto period = m_base;
+	if (m_adaptive && !_pyramid.empty())
+	{
+		m_thumb = _pyramid.gray(THUMBNAIL_WIDTH);
+		if (m_thumb.data == _pyramid.frame().data)
+			m_thumb = m_thumb.clone();	// a small gray frame is its own thumbnail, and it is kept.
+		if (!m_prev.empty() && m_prev.size() == m_thumb.size() && m_prev.type() == m_thumb.type())
+		{
+			m_stats.difference = cv::norm(m_thumb, m_prev, cv::NORM_L1) / static_cast<double>(m_thumb.total() * m_thumb.channels());
+			if (m_stats.difference > m_scene)
+				m_immediate = true;
+			if (m_stats.difference > m_stable)
+				m_period = 0;
+		}
+		else
+		{
+			m_immediate = true;
+		}
+		std::swap(m_prev, m_thumb);
+
+		period = std::min(std::max(m_period, m_base), std::max(m_max, m_base));
+	}
+	m_stats.interval = period;
+
+	auto detect = ++m_count >= period;
+	if (m_adaptive && m_immediate)
+		detect = true;
+
+	if (detect)
+	{
+		m_count = 0;
+		m_immediate = false;
+		m_stats.detections++;
+	}
+
+	const auto seconds = static_cast<double>(cv::getTickCount() - m_start) / cv::getTickFrequency();
+	m_stats.detections_per_second = seconds > 0 ? static_cast<double>(m_stats.detections) / seconds : 0;
+	m_stats.saving = m_fixed > 0 ? std::max(0.0, 1.0 - static_cast<double>(m_stats.detections) / m_fixed) : 0;
+	return detect;
+}
+
+void fvkDetectionSchedule::detected(bool _found, const cv::Rect& _face)
+{
+	if (m_adaptive)
+	{
+		if (!_found)
+		{
+			// a face that was just lost is searched again at once, then at the minimum interval.
+			if (m_found)
+				m_immediate = true;
+			m_period = 0;
+		}
+		else
+		{
+			// the face is stable if it moved less than a tenth of its size since the last detection.
+			const auto dx = std::abs((_face.x + _face.width / 2) - (m_face.x + m_face.width / 2));
+			const auto dy = std::abs((_face.y + _face.height / 2) - (m_face.y + m_face.height / 2));
+			const auto stable = m_found && dx * 10 <= _face.width && dy * 10 <= _face.height && m_stats.difference <= m_stable;
+			// the interval stops doubling at the maximum, so it cannot overflow on a steady face.
+			m_period = stable ? std::min(std::max(m_period, m_base) * 2, std::max(m_max, m_base)) : 0;
+		}
+	}
+
+	m_found = _found;
+	m_face = _face;
+}
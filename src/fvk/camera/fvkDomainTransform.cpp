@@ -0,0 +1,395 @@
+/*********************************************************************************
+created:	2026/10/19   02:40PM
+filename: 	fvkDomainTransform.cpp
+file base:	fvkDomainTransform
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that implements the non-photorealistic filters (edge preserving
+smoothing, detail enhancement, pencil sketch and stylization) on top of the
+domain transform recursive filter (Gastal and Oliveira, 2011).
+It keeps its working buffers between calls, and the passes are parallel
+over rows (horizontal) and over column stripes (vertical).
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkDomainTransform.h>
+
+#include <cmath>
+#include <algorithm>
+
+using namespace R3D;
+
+// number of pixels of a column stripe in the vertical passes.
+static const int __stripe = 128;
+
+static inline int __luma(const uchar* _p, int _cn)
+{
+	if (_cn == 1) return _p[0];
+	return (29 * _p[0] + 150 * _p[1] + 77 * _p[2] + 128) >> 8;
+}
+
+fvkDomainTransform::fvkDomainTransform() :
+m_iterations(3)
+{
+}
+
+void fvkDomainTransform::computeDerivatives(const cv::Mat& _guide)
+{
+	const auto w = _guide.cols;
+	const auto h = _guide.rows;
+	const auto cn = std::min(_guide.channels(), 3);		// alpha is not a guide channel.
+	const auto step = _guide.channels();
+
+	m_dx.create(h, w, CV_16UC1);
+	m_dy.create(h, w, CV_16UC1);
+
+	cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto p = _guide.ptr<uchar>(y);
+			const auto pu = _guide.ptr<uchar>(y > 0 ? y - 1 : 0);
+			auto dx = m_dx.ptr<ushort>(y);
+			auto dy = m_dy.ptr<ushort>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				auto sx = 0, sy = 0;
+				for (auto c = 0; c < cn; c++)
+				{
+					if (x > 0) sx += std::abs(p[x * step + c] - p[(x - 1) * step + c]);
+					sy += std::abs(p[x * step + c] - pu[x * step + c]);
+				}
+				dx[x] = static_cast<ushort>(sx);
+				dy[x] = static_cast<ushort>(sy);
+			}
+		}
+	});
+}
+
+void fvkDomainTransform::load(const cv::Mat& _src, bool _luma)
+{
+	const auto w = _src.cols;
+	const auto cn = _src.channels();
+	const auto nc = _luma ? 1 : std::min(cn, 3);
+
+	m_work.create(_src.rows, w, CV_32FC(nc));
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto p = _src.ptr<uchar>(y);
+			auto f = m_work.ptr<float>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				for (auto c = 0; c < nc; c++)
+					f[x * nc + c] = static_cast<float>(p[x * cn + c]);
+			}
+		}
+	});
+}
+
+void fvkDomainTransform::recursiveFilter(float _sigma_s, float _sigma_r, float _unit)
+{
+	const auto w = m_work.cols;
+	const auto h = m_work.rows;
+	const auto nc = m_work.channels();
+	const auto n = m_iterations;
+
+	// the derivatives are integers (at most 3 * 255), so the feedback coefficient
+	// a^(1 + sigma_s / sigma_r * d) of every derivative is taken from a table.
+	const auto maxd = 3 * 255;
+	m_lut.resize(maxd + 1);
+	const auto ratio = _sigma_s / std::max(_sigma_r, 1e-4f) * _unit;
+
+	for (auto i = 0; i < n; i++)
+	{
+		const auto sigma_h = _sigma_s * std::sqrt(3.f) * std::pow(2.f, static_cast<float>(n - i - 1)) / std::sqrt(std::pow(4.f, static_cast<float>(n)) - 1.f);
+		const auto loga = -std::sqrt(2.f) / sigma_h;
+		for (auto d = 0; d <= maxd; d++)
+			m_lut[d] = std::exp(loga * (1.f + ratio * static_cast<float>(d)));
+		const auto lut = m_lut.data();
+
+		// horizontal pass, left to right and right to left.
+		cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& _range)
+		{
+			for (auto y = _range.start; y < _range.end; y++)
+			{
+				auto f = m_work.ptr<float>(y);
+				const auto d = m_dx.ptr<ushort>(y);
+				for (auto x = 1; x < w; x++)
+				{
+					const auto a = lut[d[x]];
+					for (auto c = 0; c < nc; c++)
+						f[x * nc + c] += a * (f[(x - 1) * nc + c] - f[x * nc + c]);
+				}
+				for (auto x = w - 2; x >= 0; x--)
+				{
+					const auto a = lut[d[x + 1]];
+					for (auto c = 0; c < nc; c++)
+						f[x * nc + c] += a * (f[(x + 1) * nc + c] - f[x * nc + c]);
+				}
+			}
+		});
+
+		// vertical pass, top to bottom and bottom to top, in column stripes
+		// so that every row of a stripe is a contiguous run of memory.
+		const auto nstripes = (w + __stripe - 1) / __stripe;
+		cv::parallel_for_(cv::Range(0, nstripes), [&](const cv::Range& _range)
+		{
+			for (auto s = _range.start; s < _range.end; s++)
+			{
+				const auto x0 = s * __stripe;
+				const auto x1 = std::min(w, x0 + __stripe);
+				for (auto y = 1; y < h; y++)
+				{
+					auto f = m_work.ptr<float>(y);
+					const auto fp = m_work.ptr<float>(y - 1);
+					const auto d = m_dy.ptr<ushort>(y);
+					for (auto x = x0; x < x1; x++)
+					{
+						const auto a = lut[d[x]];
+						for (auto c = 0; c < nc; c++)
+							f[x * nc + c] += a * (fp[x * nc + c] - f[x * nc + c]);
+					}
+				}
+				for (auto y = h - 2; y >= 0; y--)
+				{
+					auto f = m_work.ptr<float>(y);
+					const auto fn = m_work.ptr<float>(y + 1);
+					const auto d = m_dy.ptr<ushort>(y + 1);
+					for (auto x = x0; x < x1; x++)
+					{
+						const auto a = lut[d[x]];
+						for (auto c = 0; c < nc; c++)
+							f[x * nc + c] += a * (fn[x * nc + c] - f[x * nc + c]);
+					}
+				}
+			}
+		});
+	}
+}
+
+auto fvkDomainTransform::gradientMagnitude() -> float
+{
+	const auto w = m_work.cols;
+	const auto h = m_work.rows;
+	const auto nc = m_work.channels();
+
+	m_mag.create(h, w, CV_32FC1);
+	std::vector<float> rowmax(h, 0.f);
+
+	cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto f = m_work.ptr<float>(y);
+			const auto fu = m_work.ptr<float>(y > 0 ? y - 1 : y);
+			const auto fd = m_work.ptr<float>(y < h - 1 ? y + 1 : y);
+			auto g = m_mag.ptr<float>(y);
+			auto mx = 0.f;
+			for (auto x = 0; x < w; x++)
+			{
+				const auto xl = (x > 0 ? x - 1 : x) * nc;
+				const auto xr = (x < w - 1 ? x + 1 : x) * nc;
+				auto s = 0.f;
+				for (auto c = 0; c < nc; c++)
+				{
+					const auto gx = f[xr + c] - f[xl + c];
+					const auto gy = fd[x * nc + c] - fu[x * nc + c];
+					s += std::sqrt(gx * gx + gy * gy);
+				}
+				g[x] = s;
+				mx = std::max(mx, s);
+			}
+			rowmax[y] = mx;
+		}
+	});
+
+	return h > 0 ? *std::max_element(rowmax.begin(), rowmax.end()) : 0.f;
+}
+
+auto fvkDomainTransform::edgePreservingFilter(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _src.channels() == 2 || _src.channels() > 4)
+		return false;
+
+	computeDerivatives(_src);
+	load(_src, false);
+	recursiveFilter(_sigma_s, _sigma_r, 1.f / 255.f);
+
+	const auto w = _src.cols;
+	const auto cn = _src.channels();
+	const auto nc = m_work.channels();
+	cv::Mat m(_src.size(), _src.type());
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto f = m_work.ptr<float>(y);
+			const auto s = _src.ptr<uchar>(y);
+			auto d = m.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				for (auto c = 0; c < nc; c++)
+					d[x * cn + c] = cv::saturate_cast<uchar>(f[x * nc + c]);
+				if (cn == 4)
+					d[x * 4 + 3] = s[x * 4 + 3];
+			}
+		}
+	});
+
+	_dst = m;
+	return true;
+}
+
+auto fvkDomainTransform::detailEnhance(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _src.channels() == 2 || _src.channels() > 4)
+		return false;
+
+	const auto w = _src.cols;
+	const auto cn = _src.channels();
+
+	m_luma.create(_src.rows, w, CV_8UC1);
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto s = _src.ptr<uchar>(y);
+			auto l = m_luma.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+				l[x] = static_cast<uchar>(__luma(s + x * cn, cn));
+		}
+	});
+
+	// cv::detailEnhance filters the Lab lightness (0 to 100) scaled by 1/255,
+	// so the luma derivatives are brought to the same units.
+	computeDerivatives(m_luma);
+	load(m_luma, true);
+	recursiveFilter(_sigma_s, _sigma_r, 100.f / (255.f * 255.f));
+
+	// L' = base + 3 * (L - base), the luma change is added to every color channel.
+	const auto factor = 3.f;
+	cv::Mat m(_src.size(), _src.type());
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto f = m_work.ptr<float>(y);
+			const auto l = m_luma.ptr<uchar>(y);
+			const auto s = _src.ptr<uchar>(y);
+			auto d = m.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				const auto delta = (factor - 1.f) * (static_cast<float>(l[x]) - f[x]);
+				for (auto c = 0; c < std::min(cn, 3); c++)
+					d[x * cn + c] = cv::saturate_cast<uchar>(s[x * cn + c] + delta);
+				if (cn == 4)
+					d[x * 4 + 3] = s[x * 4 + 3];
+			}
+		}
+	});
+
+	_dst = m;
+	return true;
+}
+
+auto fvkDomainTransform::pencilSketch(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r, float _shade_factor) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _src.channels() == 2 || _src.channels() > 4)
+		return false;
+
+	const auto w = _src.cols;
+	const auto cn = _src.channels();
+
+	m_luma.create(_src.rows, w, CV_8UC1);
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto s = _src.ptr<uchar>(y);
+			auto l = m_luma.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+				l[x] = static_cast<uchar>(__luma(s + x * cn, cn));
+		}
+	});
+
+	computeDerivatives(m_luma);
+	load(m_luma, true);
+	recursiveFilter(_sigma_s, _sigma_r, 1.f / 255.f);
+	gradientMagnitude();
+
+	// the sketch replaces the luma of the image, so the colors are kept.
+	const auto shade = std::max(_shade_factor, 1e-3f);
+	cv::Mat m(_src.size(), _src.type());
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto g = m_mag.ptr<float>(y);
+			const auto l = m_luma.ptr<uchar>(y);
+			const auto s = _src.ptr<uchar>(y);
+			auto d = m.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				const auto sketch = 255.f * std::max(0.f, 1.f - g[x] * shade);
+				const auto delta = sketch - static_cast<float>(l[x]);
+				for (auto c = 0; c < std::min(cn, 3); c++)
+					d[x * cn + c] = cv::saturate_cast<uchar>(s[x * cn + c] + delta);
+				if (cn == 4)
+					d[x * 4 + 3] = s[x * 4 + 3];
+			}
+		}
+	});
+
+	_dst = m;
+	return true;
+}
+
+auto fvkDomainTransform::stylization(const cv::Mat& _src, cv::Mat& _dst, float _sigma_s, float _sigma_r) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _src.channels() == 2 || _src.channels() > 4)
+		return false;
+
+	computeDerivatives(_src);
+	load(_src, false);
+	recursiveFilter(_sigma_s, _sigma_r, 1.f / 255.f);
+	const auto maxg = gradientMagnitude();
+	const auto inv = maxg > 0.f ? 1.f / maxg : 0.f;
+
+	const auto w = _src.cols;
+	const auto cn = _src.channels();
+	const auto nc = m_work.channels();
+	cv::Mat m(_src.size(), _src.type());
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto f = m_work.ptr<float>(y);
+			const auto g = m_mag.ptr<float>(y);
+			const auto s = _src.ptr<uchar>(y);
+			auto d = m.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				const auto k = 1.f - g[x] * inv;
+				for (auto c = 0; c < nc; c++)
+					d[x * cn + c] = cv::saturate_cast<uchar>(f[x * nc + c] * k);
+				if (cn == 4)
+					d[x * 4 + 3] = s[x * 4 + 3];
+			}
+		}
+	});
+
+	_dst = m;
+	return true;
+}
@@ -0,0 +1,104 @@
+/*********************************************************************************
+created:	2026/10/19   05:20PM
+filename: 	fvkEqualizer.cpp
+file base:	fvkEqualizer
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class for the adaptive histogram equalization (CLAHE) of the luma
+of a frame. The CLAHE object, with its tile histograms and lookup tables,
+and the luma buffers are kept between the frames.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkEqualizer.h>
+
+using namespace R3D;
+
+fvkEqualizer::fvkEqualizer() :
+m_cliplimit(0)
+{
+}
+
+auto fvkEqualizer::apply(cv::Mat& _img, double _cliplimit, const cv::Size& _tile_grid_size) -> bool
+{
+	if (_img.empty() || _img.depth() != CV_8U || _cliplimit <= 0)
+		return false;
+
+	const auto cn = _img.channels();
+	if (cn != 1 && cn != 3 && cn != 4)
+		return false;
+
+	if (!m_clahe || _cliplimit != m_cliplimit || _tile_grid_size != m_tiles)
+	{
+		m_clahe = cv::createCLAHE(_cliplimit, _tile_grid_size);
+		m_cliplimit = _cliplimit;
+		m_tiles = _tile_grid_size;
+	}
+
+	if (cn == 1)
+	{
+		// a new image, because the pixels of _img can be shared with other consumers of the frame.
+		cv::Mat dst;
+		m_clahe->apply(_img, dst);
+		_img = dst;
+		return true;
+	}
+
+	const auto w = _img.cols;
+	m_luma.create(_img.size(), CV_8UC1);
+
+	// same fixed-point luma as cv::cvtColor with CV_BGR2YCrCb.
+	cv::parallel_for_(cv::Range(0, _img.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto p = _img.ptr<uchar>(y);
+			auto l = m_luma.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				const auto q = p + x * cn;
+				l[x] = static_cast<uchar>((q[0] * 1868 + q[1] * 9617 + q[2] * 4899 + (1 << 13)) >> 14);
+			}
+		}
+	});
+
+	m_clahe->apply(m_luma, m_eqluma);
+
+	// with Cr and Cb unchanged, the YCrCb round trip adds the luma change to B, G and R.
+	// The result is a new image, because the pixels of _img can be shared with other consumers of the frame.
+	cv::Mat dst(_img.size(), _img.type());
+	cv::parallel_for_(cv::Range(0, _img.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto p = _img.ptr<uchar>(y);
+			auto o = dst.ptr<uchar>(y);
+			const auto l = m_luma.ptr<uchar>(y);
+			const auto e = m_eqluma.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				const auto d = e[x] - l[x];
+				const auto q = p + x * cn;
+				auto r = o + x * cn;
+				r[0] = cv::saturate_cast<uchar>(q[0] + d);
+				r[1] = cv::saturate_cast<uchar>(q[1] + d);
+				r[2] = cv::saturate_cast<uchar>(q[2] + d);
+				if (cn == 4)
+					r[3] = q[3];
+			}
+		}
+	});
+
+	_img = dst;
+	return true;
+}
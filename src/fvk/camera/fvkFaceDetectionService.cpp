@@ -0,0 +1,340 @@
+/*********************************************************************************
+created:	2026/10/23   09:40AM
+filename: 	fvkFaceDetectionService.cpp
+file base:	fvkFaceDetectionService
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that runs the face detection of many cameras on a fixed number
+of worker threads. Every worker has its own backend, so the model is loaded once
+per worker instead of once per camera, and every camera (client) keeps its own
+tracked face. The requests are taken by priority, then by age, a few at a time,
+and the detections are capped by a global number per second.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFaceDetectionService.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace R3D;
+
+fvkFaceDetectionService::fvkFaceDetectionService() :
+m_stop(false),
+m_type(fvkFaceDetectorBackend::Type::Haar),
+m_workers(2),
+m_batch(4),
+m_budget(0),
+m_tokens(0),
+m_refill(0),
+m_nextid(1),
+m_totalduration(0)
+{
+}
+
+fvkFaceDetectionService::~fvkFaceDetectionService()
+{
+	stop();
+}
+
+auto fvkFaceDetectionService::loadCascadeClassifier(const std::string& _filename) -> bool
+{
+	auto b = fvkFaceDetectorBackend::createFromCascade(_filename);
+	return b && loadFaceDetector(b->type(), _filename);
+}
+
+auto fvkFaceDetectionService::loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool
+{
+	int workers;
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		workers = m_workers;
+	}
+
+	// the backends are loaded before the workers are stopped, so a bad file changes nothing.
+	std::vector<std::shared_ptr<fvkFaceDetectorBackend>> backends;
+	for (auto i = 0; i < workers; i++)
+	{
+		std::shared_ptr<fvkFaceDetectorBackend> b(fvkFaceDetectorBackend::create(_type));
+		if (!b->load(_filename))
+			return false;
+		backends.push_back(b);
+	}
+
+	stop();
+
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_type = _type;
+	m_filename = _filename;
+	m_backends = backends;
+
+	// the tracked faces were found by the old model.
+	for (auto& c : m_clients)
+		c.second->reset = true;
+	return true;
+}
+
+void fvkFaceDetectionService::setWorkers(int _value)
+{
+	fvkFaceDetectorBackend::Type type;
+	std::string filename;
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_workers = std::max(_value, 1);
+		type = m_type;
+		filename = m_filename;
+	}
+	if (!filename.empty())
+		loadFaceDetector(type, filename);
+}
+auto fvkFaceDetectionService::getWorkers() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_workers;
+}
+
+void fvkFaceDetectionService::setBatchSize(int _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_batch = std::max(_value, 1);
+}
+auto fvkFaceDetectionService::getBatchSize() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_batch;
+}
+
+void fvkFaceDetectionService::setBudget(double _detections_per_second)
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_budget = std::max(_detections_per_second, 0.0);
+		m_tokens = 0;
+		m_refill = cv::getTickCount();
+	}
+	m_cond.notify_all();
+}
+auto fvkFaceDetectionService::getBudget() const -> double
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_budget;
+}
+
+auto fvkFaceDetectionService::connect(ResultFunction _fn) -> int
+{
+	std::unique_ptr<Client> c(new Client());
+	c->fn = _fn;
+	c->priority = 0;
+	c->scale = 0;
+	c->seq = 0;
+	c->submitted = 0;
+	c->has_pending = false;
+	c->reset = false;
+	c->busy = false;
+
+	std::lock_guard<std::mutex> locker(m_mutex);
+	const auto id = m_nextid++;
+	m_clients[id] = std::move(c);
+	return id;
+}
+
+void fvkFaceDetectionService::disconnect(int _client)
+{
+	std::unique_lock<std::mutex> lk(m_mutex);
+	const auto it = m_clients.find(_client);
+	if (it == m_clients.end())
+		return;
+	m_idle.wait(lk, [&]() { return !it->second->busy; });
+	m_clients.erase(it);
+}
+
+void fvkFaceDetectionService::setPriority(int _client, int _priority)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	const auto it = m_clients.find(_client);
+	if (it != m_clients.end())
+		it->second->priority = _priority;
+}
+
+void fvkFaceDetectionService::submit(int _client, const cv::Mat& _resized_frame, double _scale, const cv::Size& _frame_size, unsigned long long _seq, bool _reset)
+{
+	if (_resized_frame.empty() || _scale <= 0)
+		return;
+
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		const auto it = m_clients.find(_client);
+		if (it == m_clients.end() || m_backends.empty())
+			return;
+
+		auto& c = *it->second;
+		if (c.has_pending)
+			m_stats.replaced++;
+		else
+			c.submitted = cv::getTickCount();	// the age of a client is the one of its oldest waiting frame.
+		c.pending = _resized_frame;
+		c.scale = _scale;
+		c.size = _frame_size;
+		c.seq = _seq;
+		c.reset = c.reset || _reset;
+		c.has_pending = true;
+		m_stats.requests++;
+
+		if (m_threads.empty() && !m_stop)
+		{
+			m_tokens = 0;
+			m_refill = cv::getTickCount();
+			for (const auto& b : m_backends)
+				m_threads.emplace_back([this, b]() { run(b); });
+		}
+	}
+	m_cond.notify_one();
+}
+
+auto fvkFaceDetectionService::getStats() const -> fvkFaceDetectionServiceStats
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	auto s = m_stats;
+	s.clients = static_cast<int>(m_clients.size());
+	s.workers = static_cast<int>(m_threads.size());
+	const auto since = cv::getTickCount() - static_cast<int64>(cv::getTickFrequency());
+	s.detections_per_second = static_cast<double>(std::count_if(m_recent.begin(), m_recent.end(), [since](int64 _t) { return _t > since; }));
+	s.duration = s.detections > 0 ? m_totalduration / static_cast<double>(s.detections) : 0;
+	return s;
+}
+
+void fvkFaceDetectionService::stop()
+{
+	std::vector<std::thread> threads;
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_stop = true;
+		threads.swap(m_threads);
+	}
+	m_cond.notify_all();
+	for (auto& t : threads)
+		t.join();
+
+	// submit does not start new workers before the old ones are gone.
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_stop = false;
+}
+
+auto fvkFaceDetectionService::takeBatch(std::vector<Request>& _batch, double& _wait) -> bool
+{
+	_batch.clear();
+	_wait = 0;
+
+	std::vector<Client*> ready;
+	for (auto& c : m_clients)
+	{
+		if (c.second->has_pending && !c.second->busy)
+			ready.push_back(c.second.get());
+	}
+	if (ready.empty())
+		return false;
+
+	auto n = std::min(static_cast<int>(ready.size()), m_batch);
+	if (m_budget > 0)
+	{
+		// token bucket that holds at most one detection per worker, so the budget is not spent in bursts.
+		const auto now = cv::getTickCount();
+		const auto cap = std::max(1.0, static_cast<double>(m_threads.size()));
+		m_tokens = std::min(cap, m_tokens + static_cast<double>(now - m_refill) / cv::getTickFrequency() * m_budget);
+		m_refill = now;
+		n = std::min(n, static_cast<int>(m_tokens));
+		if (n <= 0)
+		{
+			_wait = (1.0 - m_tokens) / m_budget;
+			return false;
+		}
+		m_tokens -= n;
+	}
+
+	// highest priority first, then the client that waits for the longest time.
+	std::partial_sort(ready.begin(), ready.begin() + n, ready.end(), [](const Client* _a, const Client* _b)
+	{
+		return _a->priority != _b->priority ? _a->priority > _b->priority : _a->submitted < _b->submitted;
+	});
+
+	for (auto i = 0; i < n; i++)
+	{
+		auto c = ready[i];
+		_batch.push_back(Request { c, c->pending, c->scale, c->size, c->seq, c->reset });
+		c->pending.release();
+		c->has_pending = false;
+		c->reset = false;
+		c->busy = true;
+	}
+	return true;
+}
+
+void fvkFaceDetectionService::run(std::shared_ptr<fvkFaceDetectorBackend> _backend)
+{
+	std::vector<Request> batch;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			while (true)
+			{
+				if (m_stop)
+					return;
+				double wait;
+				if (takeBatch(batch, wait))
+					break;
+				if (wait > 0)
+					m_cond.wait_for(lk, std::chrono::duration<double>(wait));
+				else
+					m_cond.wait(lk);
+			}
+		}
+
+		// the clients of the batch are busy, so no other worker and no disconnect touches them.
+		for (auto& r : batch)
+		{
+			auto& fd = r.client->fd;
+			const auto t = cv::getTickCount();
+			if (r.reset)
+				fd.reset();
+			fd.shareBackend(_backend);
+			fd.detectResized(r.frame, r.scale);
+
+			fvkFaceResult result;
+			result.rect = fd.getRect();
+			result.frame_size = r.size;
+			result.seq = r.seq;
+			result.found = fd.isFaceFound();
+			result.duration = static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency();
+
+			if (r.client->fn)
+				r.client->fn(result);
+
+			{
+				std::lock_guard<std::mutex> locker(m_mutex);
+				r.client->busy = false;
+				m_stats.detections++;
+				m_totalduration += result.duration;
+
+				const auto now = cv::getTickCount();
+				m_recent.push_back(now);
+				while (!m_recent.empty() && now - m_recent.front() > static_cast<int64>(cv::getTickFrequency()))
+					m_recent.pop_front();
+			}
+			m_idle.notify_all();
+		}
+
+		// a client that was busy may have a new frame waiting.
+		m_cond.notify_one();
+	}
+}
@@ -27,7 +27,6 @@ using namespace R3D;
 const double fvkFaceDetector::TICK_FREQUENCY = cv::getTickFrequency();
 
 fvkFaceDetector::fvkFaceDetector() : 
-m_face_cascade(nullptr),
 m_template_matching_running(false),
 m_template_matching_start_time(0),
 m_template_matching_current_time(0),
@@ -39,14 +38,12 @@ m_template_matching_max_duration(3)
 }
 fvkFaceDetector::~fvkFaceDetector()
 {
-	if (m_face_cascade) 
-		delete m_face_cascade;
-	m_face_cascade = nullptr;
 }
 void fvkFaceDetector::reset()
 {
 	m_template_matching_running = false;
 	m_found_face = false;
+	m_face_velocity = cv::Point();
 }
 
 auto fvkFaceDetector::setFaceCascade(const std::string& _cascade_file_path) -> bool
@@ -54,30 +51,46 @@ auto fvkFaceDetector::setFaceCascade(const std::string& _cascade_file_path) -> b
 	if (_cascade_file_path.empty()) 
 		return false;
 
-	if (m_face_cascade == nullptr)
+	// the type of the backend (Haar or LBP) is the one of the features in the file.
+	auto b = fvkFaceDetectorBackend::createFromCascade(_cascade_file_path);
+	if (!b)
 	{
-		m_face_cascade = new cv::CascadeClassifier(_cascade_file_path);
-	}
-	else
-	{
-		if (!m_face_cascade->load(_cascade_file_path))
-		{
-			std::cerr << "ERROR: couldn't create cascade classifier. Make sure the file exists." << std::endl;
-			return false;
-		}
+		std::cerr << "ERROR: couldn't create cascade classifier. Make sure the file exists." << std::endl;
+		return false;
 	}
 
-	if (m_face_cascade->empty())
+	m_backend = std::move(b);
+	reset();
+
+	return true;
+}
+
+auto fvkFaceDetector::setBackend(fvkFaceDetectorBackend::Type _type, const std::string& _model_file_path) -> bool
+{
+	auto b = fvkFaceDetectorBackend::create(_type);
+	if (!b->load(_model_file_path))
 	{
-		std::cerr << "ERROR: couldn't create cascade classifier. Make sure the file exists." << std::endl;
+		std::cerr << "ERROR: couldn't load the " << fvkFaceDetectorBackend::name(_type) << " face detector. Make sure the file exists." << std::endl;
 		return false;
 	}
 
+	m_backend = std::move(b);
 	reset();
 
 	return true;
 }
 
+void fvkFaceDetector::shareBackend(const std::shared_ptr<fvkFaceDetectorBackend>& _backend)
+{
+	m_backend = _backend;
+}
+
+auto fvkFaceDetector::getFaceCascade() const -> cv::CascadeClassifier*
+{
+	auto c = dynamic_cast<fvkCascadeBackend*>(m_backend.get());
+	return c ? &c->get() : nullptr;
+}
+
 void fvkFaceDetector::setResizedWidth(const int _width)
 {
 	m_resized_width = std::max(_width, 1);
@@ -180,8 +193,8 @@ void fvkFaceDetector::detectFaceAllSizes(const cv::Mat& _frame)
 {
 	// Minimum face size is 1/5th of screen height
 	// Maximum face size is 2/3rds of screen height
-	m_face_cascade->detectMultiScale(
-		_frame, m_all_faces, 1.1, 3, 0,
+	m_backend->detect(
+		_frame, m_all_faces,
 		cv::Size(_frame.rows / 5, _frame.rows / 5),
 		cv::Size(_frame.rows * 2 / 3, _frame.rows * 2 / 3));
 
@@ -198,15 +211,16 @@ void fvkFaceDetector::detectFaceAllSizes(const cv::Mat& _frame)
 	// Calculate roi
 	m_face_roi = doubleRectSize(m_tracked_face, cv::Rect(0, 0, _frame.cols, _frame.rows));
 
-	// Update face position
+	// Update face position, without a motion
 	m_face_position = centerOfRect(m_tracked_face);
+	m_face_velocity = cv::Point();
 }
 
 void fvkFaceDetector::detectFaceAroundRoi(const cv::Mat& _frame)
 {
 	// Detect faces sized +/-20% off biggest face in previous search
-	m_face_cascade->detectMultiScale(
-		_frame(m_face_roi), m_all_faces, 1.1, 3, 0,
+	m_backend->detect(
+		_frame(m_face_roi), m_all_faces,
 		cv::Size(m_tracked_face.width * 8 / 10, m_tracked_face.height * 8 / 10),
 		cv::Size(m_tracked_face.width * 12 / 10, m_tracked_face.width * 12 / 10));
 
@@ -237,7 +251,7 @@ void fvkFaceDetector::detectFaceAroundRoi(const cv::Mat& _frame)
 	m_face_roi = doubleRectSize(m_tracked_face, cv::Rect(0, 0, _frame.cols, _frame.rows));
 
 	// Update face position
-	m_face_position = centerOfRect(m_tracked_face);
+	updatePosition(centerOfRect(m_tracked_face));
 }
 
 void fvkFaceDetector::detectFacesTemplateMatching(const cv::Mat& _frame)
@@ -255,58 +269,139 @@ void fvkFaceDetector::detectFacesTemplateMatching(const cv::Mat& _frame)
 		m_template_matching_start_time = m_template_matching_current_time = 0;
 	}
 
-	// Template matching with last known face 
-	//cv::matchTemplate(frame(m_faceRoi), m_faceTemplate, m_matchingResult, CV_TM_CCOEFF);
-	cv::matchTemplate(_frame(m_face_roi), m_face_template, m_matching_result, CV_TM_SQDIFF_NORMED);
-	cv::normalize(m_matching_result, m_matching_result, 0, 1, cv::NORM_MINMAX, -1, cv::Mat());
-	double min, max;
-	cv::Point min_loc, max_loc;
-	cv::minMaxLoc(m_matching_result, &min, &max, &min_loc, &max_loc);
+	// Template matching with last known face, in the roi moved along the last motion
+	const auto frame_rect = cv::Rect(0, 0, _frame.cols, _frame.rows);
+	auto roi = (m_face_roi + m_face_velocity) & frame_rect;
+	if (roi.width < m_face_template.cols || roi.height < m_face_template.rows)
+		roi = m_face_roi;
+	if (m_face_template.empty() || roi.width < m_face_template.cols || roi.height < m_face_template.rows)
+	{
+		m_found_face = false;
+		m_template_matching_running = false;
+		m_template_matching_start_time = m_template_matching_current_time = 0;
+		return;
+	}
 
 	// Add roi offset to face position
-	min_loc.x += m_face_roi.x;
-	min_loc.y += m_face_roi.y;
+	const auto min_loc = matchFaceTemplate(_frame(roi)) + roi.tl();
 
 	// Get detected face
-	//m_trackedFace = cv::Rect(maxLoc.x, maxLoc.y, m_trackedFace.width, m_trackedFace.height);
 	m_tracked_face = cv::Rect(min_loc.x, min_loc.y, m_face_template.cols, m_face_template.rows);
-	m_tracked_face = doubleRectSize(m_tracked_face, cv::Rect(0, 0, _frame.cols, _frame.rows));
+	m_tracked_face = doubleRectSize(m_tracked_face, frame_rect);
 
 	// Get new face template
 	m_face_template = getFaceTemplate(_frame, m_tracked_face);
 
 	// Calculate face roi
-	m_face_roi = doubleRectSize(m_tracked_face, cv::Rect(0, 0, _frame.cols, _frame.rows));
+	m_face_roi = doubleRectSize(m_tracked_face, frame_rect);
 
 	// Update face position
-	m_face_position = centerOfRect(m_tracked_face);
+	updatePosition(centerOfRect(m_tracked_face));
+}
+
+/*
+* Best match (minimum squared difference) of the face template in the image. Templates of 16 pixels
+* or more are searched coarse to fine: at half resolution over the whole image, then at full
+* resolution within 2 pixels of the coarse match. minMaxLoc does not need a normalized result.
+*/
+auto fvkFaceDetector::matchFaceTemplate(const cv::Mat& _image) -> cv::Point
+{
+	cv::Point loc;
+	if (m_face_template.cols < 16 || m_face_template.rows < 16)
+	{
+		cv::matchTemplate(_image, m_face_template, m_matching_result, CV_TM_SQDIFF_NORMED);
+		cv::minMaxLoc(m_matching_result, nullptr, nullptr, &loc);
+		return loc;
+	}
+
+	cv::pyrDown(_image, m_pyr_image);
+	cv::pyrDown(m_face_template, m_pyr_template);
+	cv::matchTemplate(m_pyr_image, m_pyr_template, m_matching_result, CV_TM_SQDIFF_NORMED);
+	cv::minMaxLoc(m_matching_result, nullptr, nullptr, &loc);
+
+	const auto r = 2;
+	const auto window = cv::Rect(loc.x * 2 - r, loc.y * 2 - r, m_face_template.cols + 2 * r, m_face_template.rows + 2 * r) & cv::Rect(0, 0, _image.cols, _image.rows);
+	if (window.width < m_face_template.cols || window.height < m_face_template.rows)
+		return loc * 2;
+
+	cv::matchTemplate(_image(window), m_face_template, m_refined_result, CV_TM_SQDIFF_NORMED);
+	cv::minMaxLoc(m_refined_result, nullptr, nullptr, &loc);
+	return loc + window.tl();
+}
+
+void fvkFaceDetector::updatePosition(const cv::Point& _position)
+{
+	m_face_velocity = _position - m_face_position;
+	m_face_position = _position;
+}
+
+auto fvkFaceDetector::downscale(const cv::Mat& _frame, cv::Mat& _resized_frame, int _width) -> double
+{
+	fvkFramePyramid pyramid(_frame);
+	return downscale(pyramid, _resized_frame, _width);
+}
+
+auto fvkFaceDetector::downscale(fvkFramePyramid& _pyramid, cv::Mat& _resized_frame, int _width) -> double
+{
+	const auto& frame = _pyramid.frame();
+	if (frame.empty() || _width <= 0)
+		return 0;
+
+	// Downscale frame to _width width - keep aspect ratio
+	if (_width > frame.cols / 2)
+		return 0;
+
+	_resized_frame = _pyramid.level(_width);
+	return static_cast<double>(_resized_frame.cols) / static_cast<double>(frame.cols);
 }
 
 auto fvkFaceDetector::detect(cv::Mat& _frame) -> cv::Point
 {
-	// Downscale frame to m_resizedWidth width - keep aspect ratio
-	m_scale = static_cast<double>(std::min(m_resized_width, _frame.cols) / static_cast<double>(_frame.cols));
-	const auto resized_frame_size = cv::Size(static_cast<int>(m_scale*_frame.cols), static_cast<int>(m_scale*_frame.rows));
-	if (resized_frame_size.width > (_frame.cols/2) || resized_frame_size.height > (_frame.rows/2))
-		return m_face_position;
+	fvkFramePyramid pyramid(_frame);
+	return detect(pyramid);
+}
 
+auto fvkFaceDetector::detect(fvkFramePyramid& _pyramid) -> cv::Point
+{
 	cv::Mat resized_frame;
-	cv::resize(_frame, resized_frame, resized_frame_size);
+	const auto scale = downscale(_pyramid, resized_frame, m_resized_width);
+	if (scale <= 0)
+		return m_face_position;
+
+	return detectResized(resized_frame, scale);
+}
+
+auto fvkFaceDetector::detectResized(const cv::Mat& _resized_frame, double _scale) -> cv::Point
+{
+	if (!m_backend || m_backend->empty() || _resized_frame.empty() || _scale <= 0)
+		return m_face_position;
+
+	m_scale = _scale;
 
 	if (!m_found_face)
 	{
-		detectFaceAllSizes(resized_frame); // Detect using cascades over whole image
+		detectFaceAllSizes(_resized_frame); // Detect using cascades over whole image
 	}
 	else 
 	{
-		detectFaceAroundRoi(resized_frame); // Detect using cascades only in ROI
+		detectFaceAroundRoi(_resized_frame); // Detect using cascades only in ROI
 		if (m_template_matching_running) 
-			detectFacesTemplateMatching(resized_frame); // Detect using template matching
+			detectFacesTemplateMatching(_resized_frame); // Detect using template matching
 	}
 
 	return m_face_position;
 }
 
+auto fvkFaceDetector::isFaceFound() const -> bool
+{
+	return m_found_face;
+}
+
+auto fvkFaceDetector::isTemplateMatchingRunning() const -> bool
+{
+	return m_template_matching_running;
+}
+
 auto fvkFaceDetector::operator >> (cv::Mat& _frame) -> cv::Point
 {
 	return detect(_frame);
@@ -318,6 +413,7 @@ auto fvkFaceDetector::operator >> (cv::Mat& _frame) -> cv::Point
 
 fvkSimpleFaceDetector::fvkSimpleFaceDetector() : 
 m_filepath(""),
+m_type(fvkFaceDetectorBackend::Type::Haar),
 m_nframes(0)
 {
 }
@@ -327,6 +423,19 @@ auto fvkSimpleFaceDetector::loadCascadeClassifier(const std::string& _filename)
 	if (m_fd.setFaceCascade(_filename))
 	{
 		m_filepath = _filename;
+		m_type = m_fd.getBackend()->type();
+		return true;
+	}
+	m_filepath = "";
+	return false;
+}
+
+auto fvkSimpleFaceDetector::loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool
+{
+	if (m_fd.setBackend(_type, _filename))
+	{
+		m_filepath = _filename;
+		m_type = _type;
 		return true;
 	}
 	m_filepath = "";
@@ -335,9 +444,16 @@ auto fvkSimpleFaceDetector::loadCascadeClassifier(const std::string& _filename)
 
 void fvkSimpleFaceDetector::detect(cv::Mat& _frame, const int _frame_delay_in_detection)
 {
-	if (m_nframes > _frame_delay_in_detection)
+	fvkFramePyramid pyramid(_frame);
+	detect(pyramid, _frame_delay_in_detection);
+}
+
+void fvkSimpleFaceDetector::detect(fvkFramePyramid& _pyramid, const int _frame_delay_in_detection)
+{
+	if (m_schedule.next(_pyramid, _frame_delay_in_detection))
 	{
-		m_fd.detect(_frame);
+		m_fd.detect(_pyramid);
+		m_schedule.detected(m_fd.isFaceFound() && !m_fd.isTemplateMatchingRunning(), m_fd.getRect());
 		m_nframes = 0;
 	}
 	m_nframes++;
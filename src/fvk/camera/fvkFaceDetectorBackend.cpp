@@ -0,0 +1,158 @@
+/*********************************************************************************
+created:	2026/10/22   02:20PM
+filename: 	fvkFaceDetectorBackend.cpp
+file base:	fvkFaceDetectorBackend
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	interface of the algorithms that find the faces for fvkFaceDetector,
+with a Haar cascade, an LBP cascade and a HOG detector.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFaceDetectorBackend.h>
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+using namespace R3D;
+
+// feature types of cv::CascadeClassifier::getFeatureType().
+static const int CASCADE_HAAR = 0;
+static const int CASCADE_LBP = 1;
+
+auto fvkFaceDetectorBackend::create(Type _type) -> std::unique_ptr<fvkFaceDetectorBackend>
+{
+	if (_type == Type::Hog)
+		return std::unique_ptr<fvkFaceDetectorBackend>(new fvkHogBackend());
+	return std::unique_ptr<fvkFaceDetectorBackend>(new fvkCascadeBackend(_type));
+}
+
+auto fvkFaceDetectorBackend::createFromCascade(const std::string& _filename) -> std::unique_ptr<fvkFaceDetectorBackend>
+{
+	cv::CascadeClassifier c;
+	if (_filename.empty() || !c.load(_filename) || c.empty())
+		return nullptr;
+
+	auto b = create(c.getFeatureType() == CASCADE_LBP ? Type::Lbp : Type::Haar);
+	if (!b->load(_filename))
+		return nullptr;
+	return b;
+}
+
+auto fvkFaceDetectorBackend::name(Type _type) -> std::string
+{
+	switch (_type)
+	{
+	case Type::Haar: return "Haar";
+	case Type::Lbp: return "LBP";
+	case Type::Hog: return "HOG";
+	}
+	return "";
+}
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+
+fvkCascadeBackend::fvkCascadeBackend(Type _type) :
+m_type(_type)
+{
+}
+
+auto fvkCascadeBackend::type() const -> Type
+{
+	return m_type;
+}
+
+auto fvkCascadeBackend::load(const std::string& _filename) -> bool
+{
+	cv::CascadeClassifier c;
+	if (_filename.empty() || !c.load(_filename) || c.empty())
+		return false;
+	if (c.getFeatureType() != (m_type == Type::Lbp ? CASCADE_LBP : CASCADE_HAAR))
+		return false;
+
+	m_cascade = c;
+	return true;
+}
+
+auto fvkCascadeBackend::empty() const -> bool
+{
+	return m_cascade.empty();
+}
+
+void fvkCascadeBackend::detect(const cv::Mat& _gray, std::vector<cv::Rect>& _faces, const cv::Size& _min_size, const cv::Size& _max_size)
+{
+	m_cascade.detectMultiScale(_gray, _faces, 1.1, 3, 0, _min_size, _max_size);
+}
+
+/************************************************************************/
+/*                                                                      */
+/************************************************************************/
+
+fvkHogBackend::fvkHogBackend()
+{
+}
+
+auto fvkHogBackend::type() const -> Type
+{
+	return Type::Hog;
+}
+
+auto fvkHogBackend::load(const std::string& _filename) -> bool
+{
+	cv::HOGDescriptor h;
+	if (_filename.empty() || !h.load(_filename) || h.svmDetector.empty())
+		return false;
+
+	m_hog = h;
+	return true;
+}
+
+auto fvkHogBackend::empty() const -> bool
+{
+	return m_hog.svmDetector.empty();
+}
+
+void fvkHogBackend::detect(const cv::Mat& _gray, std::vector<cv::Rect>& _faces, const cv::Size& _min_size, const cv::Size& _max_size)
+{
+	_faces.clear();
+	if (empty() || _gray.empty())
+		return;
+
+	// the window is the smallest face, so the image is scaled to make _min_size fit in it,
+	// which also saves the levels of the pyramid below the minimum size.
+	auto scale = 1.0;
+	if (_min_size.width > m_hog.winSize.width)
+		scale = static_cast<double>(m_hog.winSize.width) / _min_size.width;
+	const cv::Mat* img = &_gray;
+	if (scale < 1.0)
+	{
+		cv::resize(_gray, m_resized, cv::Size(), scale, scale, cv::INTER_AREA);
+		img = &m_resized;
+	}
+	if (img->cols < m_hog.winSize.width || img->rows < m_hog.winSize.height)
+		return;
+
+	m_hog.detectMultiScale(*img, _faces, 0, cv::Size(8, 8), cv::Size(), 1.1);
+
+	auto last = _faces.begin();
+	for (auto r : _faces)
+	{
+		r = cv::Rect(cvRound(r.x / scale), cvRound(r.y / scale), cvRound(r.width / scale), cvRound(r.height / scale));
+		if (_max_size.area() > 0 && (r.width > _max_size.width || r.height > _max_size.height))
+			continue;
+		*last++ = r & cv::Rect(cv::Point(0, 0), _gray.size());
+	}
+	_faces.erase(last, _faces.end());
+}
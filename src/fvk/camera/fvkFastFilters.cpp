@@ -0,0 +1,615 @@
+/*********************************************************************************
+created:	2026/10/19   10:12AM
+filename: 	fvkFastFilters.cpp
+file base:	fvkFastFilters
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class with fast approximations of the expensive smoothing filters
+whose cost does not grow (or grows very slowly) with the kernel size.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFastFilters.h>
+
+#include <vector>
+#include <climits>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace R3D;
+
+static inline int __clamp(int _v, int _lo, int _hi)
+{
+	return _v < _lo ? _lo : (_v > _hi ? _hi : _v);
+}
+
+/************************************************************************/
+/* Constant-time median                                                 */
+/************************************************************************/
+
+// Description:
+// Filters the rows [_range.start, _range.end) of one channel.
+// Every column keeps a coarse (16 bins) and a fine (256 bins) histogram of the
+// pixels in the vertical window. The kernel histogram is obtained by sliding over
+// the column histograms, and the fine kernel bins are only synchronized for the
+// coarse bin that contains the median (lazy update).
+static void __medianRows(const cv::Mat& _src, cv::Mat& _dst, int _radius, int _channel, const cv::Range& _range, std::vector<ushort>& _hc, std::vector<ushort>& _hf)
+{
+	const auto w = _src.cols;
+	const auto h = _src.rows;
+	const auto cn = _src.channels();
+	const auto r = _radius;
+	const auto rank = ((2 * r + 1) * (2 * r + 1)) / 2;
+
+	std::fill(_hc.begin(), _hc.end(), static_cast<ushort>(0));
+	std::fill(_hf.begin(), _hf.end(), static_cast<ushort>(0));
+
+	// column histograms of the first row of this band.
+	for (auto dy = -r; dy <= r; dy++)
+	{
+		const auto p = _src.ptr<uchar>(__clamp(_range.start + dy, 0, h - 1));
+		for (auto x = 0; x < w; x++)
+		{
+			const auto v = p[x * cn + _channel];
+			_hc[x * 16 + (v >> 4)]++;
+			_hf[x * 256 + v]++;
+		}
+	}
+
+	ushort kc[16];
+	ushort kf[256];
+	int synced[16];
+
+	for (auto y = _range.start; y < _range.end; y++)
+	{
+		// slide the column histograms down by one row.
+		if (y > _range.start)
+		{
+			const auto pout = _src.ptr<uchar>(__clamp(y - r - 1, 0, h - 1));
+			const auto pin = _src.ptr<uchar>(__clamp(y + r, 0, h - 1));
+			for (auto x = 0; x < w; x++)
+			{
+				const auto vo = pout[x * cn + _channel];
+				const auto vi = pin[x * cn + _channel];
+				_hc[x * 16 + (vo >> 4)]--;
+				_hf[x * 256 + vo]--;
+				_hc[x * 16 + (vi >> 4)]++;
+				_hf[x * 256 + vi]++;
+			}
+		}
+
+		// kernel histogram at the first column.
+		std::memset(kc, 0, sizeof(kc));
+		for (auto dx = -r; dx <= r; dx++)
+		{
+			const auto c = &_hc[__clamp(dx, 0, w - 1) * 16];
+			for (auto b = 0; b < 16; b++)
+				kc[b] += c[b];
+		}
+		for (auto b = 0; b < 16; b++)
+			synced[b] = INT_MIN;
+
+		auto d = _dst.ptr<uchar>(y);
+		for (auto x = 0; x < w; x++)
+		{
+			if (x > 0)
+			{
+				const auto cin = &_hc[__clamp(x + r, 0, w - 1) * 16];
+				const auto cout = &_hc[__clamp(x - r - 1, 0, w - 1) * 16];
+				for (auto b = 0; b < 16; b++)
+					kc[b] += cin[b] - cout[b];
+			}
+
+			// find the coarse bin that contains the median.
+			auto sum = 0;
+			auto b = 0;
+			for (; b < 15; b++)
+			{
+				if (sum + kc[b] > rank)
+					break;
+				sum += kc[b];
+			}
+
+			// bring the fine bins of that coarse bin up to date.
+			const auto seg = &kf[b * 16];
+			if (synced[b] == INT_MIN || (x - synced[b]) * 2 > 2 * r + 1)
+			{
+				std::memset(seg, 0, 16 * sizeof(ushort));
+				for (auto dx = -r; dx <= r; dx++)
+				{
+					const auto f = &_hf[__clamp(x + dx, 0, w - 1) * 256 + b * 16];
+					for (auto i = 0; i < 16; i++)
+						seg[i] += f[i];
+				}
+			}
+			else
+			{
+				for (auto j = synced[b] + 1; j <= x; j++)
+				{
+					const auto fin = &_hf[__clamp(j + r, 0, w - 1) * 256 + b * 16];
+					const auto fout = &_hf[__clamp(j - r - 1, 0, w - 1) * 256 + b * 16];
+					for (auto i = 0; i < 16; i++)
+						seg[i] += fin[i] - fout[i];
+				}
+			}
+			synced[b] = x;
+
+			// find the median in the fine bins.
+			auto v = 0;
+			for (; v < 15; v++)
+			{
+				if (sum + seg[v] > rank)
+					break;
+				sum += seg[v];
+			}
+
+			d[x * cn + _channel] = static_cast<uchar>(b * 16 + v);
+		}
+	}
+}
+
+auto fvkFastFilters::medianFilter(const cv::Mat& _src, cv::Mat& _dst, int _ksize) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U)
+		return false;
+
+	const auto cn = _src.channels();
+	if (cn != 1 && cn != 3 && cn != 4)
+		return false;
+
+	// kernel histogram bins are 16-bit, so the window must have less than 65536 pixels.
+	if (_ksize < 3 || _ksize % 2 == 0 || _ksize > 255)
+		return false;
+
+	const auto r = _ksize / 2;
+	const auto w = _src.cols;
+	cv::Mat m(_src.size(), _src.type());
+
+	// every band re-initializes its column histograms from 2r+1 rows,
+	// so the bands should be considerably taller than the kernel.
+	const auto nstripes = std::max(1, _src.rows / std::max(64, 4 * _ksize));
+
+	cv::parallel_for_(cv::Range(0, _src.rows), [&](const cv::Range& _range)
+	{
+		std::vector<ushort> hc(static_cast<std::size_t>(w) * 16);
+		std::vector<ushort> hf(static_cast<std::size_t>(w) * 256);
+		for (auto c = 0; c < cn; c++)
+			__medianRows(_src, m, r, c, _range, hc, hf);
+	}, static_cast<double>(nstripes));
+
+	_dst = m;
+	return true;
+}
+
+/************************************************************************/
+/* Bilateral grid                                                       */
+/************************************************************************/
+
+// Description:
+// Blurs the grid along one axis with the 5-tap binomial kernel [1 4 6 4 1] / 16.
+// The grid is stored as [y][x][z][channel] where z is the range (intensity) axis.
+static void __blurGridAxis(const std::vector<float>& _in, std::vector<float>& _out, int _gh, int _gw, int _gd, int _nc, int _axis)
+{
+	static const float k[5] = { 1.f / 16.f, 4.f / 16.f, 6.f / 16.f, 4.f / 16.f, 1.f / 16.f };
+
+	const auto sz = _nc;
+	const auto sx = _gd * _nc;
+	const auto sy = _gw * _gd * _nc;
+
+	int n, stride, lines;
+	if (_axis == 0)			{ n = _gw; stride = sx; lines = _gh * _gd; }
+	else if (_axis == 1)	{ n = _gh; stride = sy; lines = _gw * _gd; }
+	else					{ n = _gd; stride = sz; lines = _gh * _gw; }
+
+	cv::parallel_for_(cv::Range(0, lines), [&](const cv::Range& _range)
+	{
+		for (auto l = _range.start; l < _range.end; l++)
+		{
+			int base;
+			if (_axis == 0)			base = (l / _gd) * sy + (l % _gd) * sz;
+			else if (_axis == 1)	base = (l / _gd) * sx + (l % _gd) * sz;
+			else					base = l * sx;
+
+			for (auto i = 0; i < n; i++)
+			{
+				const auto o = base + i * stride;
+				for (auto c = 0; c < _nc; c++)
+				{
+					auto acc = 0.f;
+					for (auto t = -2; t <= 2; t++)
+					{
+						const auto j = i + t;
+						if (j >= 0 && j < n)
+							acc += k[t + 2] * _in[base + j * stride + c];
+					}
+					_out[o + c] = acc;
+				}
+			}
+		}
+	});
+}
+
+// Description:
+// Returns the guide (range) value of a pixel, its luma for color images.
+static inline int __guide(const uchar* _p, int _cn)
+{
+	if (_cn == 1)
+		return _p[0];
+	return (29 * _p[0] + 150 * _p[1] + 77 * _p[2] + 128) >> 8;
+}
+
+auto fvkFastFilters::bilateralFilter(const cv::Mat& _src, cv::Mat& _dst, double _sigma_color, double _sigma_space) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U)
+		return false;
+
+	const auto cn = _src.channels();
+	if (cn != 1 && cn != 3 && cn != 4)
+		return false;
+
+	const auto w = _src.cols;
+	const auto h = _src.rows;
+
+	// the grid is sampled at the rate of the sigmas, the blur of the grid
+	// is then a small gaussian with sigma of ~1 grid cell.
+	// sampling is limited to 2 pixels/levels, finer grids cost more than the exact filter.
+	const auto ss = std::max(_sigma_space, 2.0);
+	const auto sr = std::max(_sigma_color, 2.0);
+	const auto pad = 2;
+	const auto gw = cvFloor((w - 1) / ss) + 1 + 2 * pad;
+	const auto gh = cvFloor((h - 1) / ss) + 1 + 2 * pad;
+	const auto gd = cvFloor(255.0 / sr) + 1 + 2 * pad;
+	const auto nc = cn + 1;	// homogeneous coordinates: channel sums and the weight.
+
+	std::vector<float> grid(static_cast<std::size_t>(gw) * gh * gd * nc, 0.f);
+	std::vector<float> temp(grid.size());
+
+	// rows of the image that fall into each row of the grid, so the splatting
+	// can be done in parallel without two threads writing into the same cell.
+	std::vector<int> row_start(gh + 1, h);
+	for (auto y = h - 1; y >= 0; y--)
+		row_start[cvRound(y / ss) + pad] = y;
+	for (auto j = gh - 1; j >= 0; j--)
+		row_start[j] = std::min(row_start[j], row_start[j + 1]);
+
+	// splat (nearest neighbor).
+	cv::parallel_for_(cv::Range(0, gh), [&](const cv::Range& _range)
+	{
+		for (auto j = _range.start; j < _range.end; j++)
+		{
+			for (auto y = row_start[j]; y < row_start[j + 1]; y++)
+			{
+				const auto p = _src.ptr<uchar>(y);
+				const auto row = &grid[static_cast<std::size_t>(j) * gw * gd * nc];
+				for (auto x = 0; x < w; x++)
+				{
+					const auto px = p + x * cn;
+					const auto gx = cvRound(x / ss) + pad;
+					const auto gz = cvRound(__guide(px, cn) / sr) + pad;
+					const auto cell = row + (gx * gd + gz) * nc;
+					for (auto c = 0; c < cn; c++)
+						cell[c] += px[c];
+					cell[cn] += 1.f;
+				}
+			}
+		}
+	});
+
+	// blur.
+	__blurGridAxis(grid, temp, gh, gw, gd, nc, 0);
+	__blurGridAxis(temp, grid, gh, gw, gd, nc, 1);
+	__blurGridAxis(grid, temp, gh, gw, gd, nc, 2);
+
+	// slice (trilinear interpolation).
+	cv::Mat m(_src.size(), _src.type());
+	cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& _range)
+	{
+		std::vector<float> acc(nc);
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto p = _src.ptr<uchar>(y);
+			auto d = m.ptr<uchar>(y);
+
+			const auto fy = y / ss + pad;
+			const auto iy = static_cast<int>(fy);
+			const auto wy = static_cast<float>(fy - iy);
+
+			for (auto x = 0; x < w; x++)
+			{
+				const auto fx = x / ss + pad;
+				const auto ix = static_cast<int>(fx);
+				const auto wx = static_cast<float>(fx - ix);
+				const auto fz = __guide(p + x * cn, cn) / sr + pad;
+				const auto iz = static_cast<int>(fz);
+				const auto wz = static_cast<float>(fz - iz);
+
+				std::fill(acc.begin(), acc.end(), 0.f);
+				for (auto ty = 0; ty < 2; ty++)
+				{
+					const auto wyy = ty ? wy : 1.f - wy;
+					for (auto tx = 0; tx < 2; tx++)
+					{
+						const auto wxy = wyy * (tx ? wx : 1.f - wx);
+						const auto cell = &temp[((static_cast<std::size_t>(iy + ty) * gw + (ix + tx)) * gd + iz) * nc];
+						const auto w0 = wxy * (1.f - wz);
+						const auto w1 = wxy * wz;
+						for (auto c = 0; c < nc; c++)
+							acc[c] += w0 * cell[c] + w1 * cell[nc + c];
+					}
+				}
+
+				if (acc[cn] > 1e-6f)
+				{
+					for (auto c = 0; c < cn; c++)
+						d[x * cn + c] = cv::saturate_cast<uchar>(acc[c] / acc[cn]);
+				}
+				else
+				{
+					for (auto c = 0; c < cn; c++)
+						d[x * cn + c] = p[x * cn + c];
+				}
+			}
+		}
+	});
+
+	_dst = m;
+	return true;
+}
+
+/************************************************************************/
+/* Stacked box blur gaussian                                            */
+/************************************************************************/
+
+// Description:
+// Reflects an out of range index, gfedcb|abcdefgh|gfedcba (BORDER_REFLECT_101).
+static inline int __reflect101(int _i, int _n)
+{
+	if (_n == 1)
+		return 0;
+	while (_i < 0 || _i >= _n)
+	{
+		if (_i < 0)
+			_i = -_i;
+		if (_i >= _n)
+			_i = 2 * _n - 2 - _i;
+	}
+	return _i;
+}
+
+// Description:
+// Box radii of the three box blurs whose composition has the given sigma (Kovesi, 2010).
+static void __boxRadii(double _sigma, int _radii[3])
+{
+	const auto n = 3;
+	auto wl = cvFloor(std::sqrt(12.0 * _sigma * _sigma / n + 1.0));
+	if (wl % 2 == 0)
+		wl--;
+	const auto wu = wl + 2;
+	const auto m = cvRound((12.0 * _sigma * _sigma - n * wl * wl - 4.0 * n * wl - 3.0 * n) / (-4.0 * wl - 4.0));
+	for (auto i = 0; i < n; i++)
+		_radii[i] = ((i < m) ? wl : wu) / 2;
+}
+
+// Description:
+// Box blur of one line of _n interleaved pixels (_cn channels) with running sums.
+// _stride is the distance (in elements) between two pixels of the line in _in and _out.
+template <typename T>
+static void __boxLine(const T* _in, float* _out, int _n, int _cn, int _r, std::size_t _stride)
+{
+	const auto scale = 1.f / static_cast<float>(2 * _r + 1);
+	for (auto c = 0; c < _cn; c++)
+	{
+		auto sum = 0.f;
+		for (auto k = -_r; k <= _r; k++)
+			sum += static_cast<float>(_in[__reflect101(k, _n) * _stride + c]);
+		_out[c] = sum * scale;
+
+		for (auto i = 1; i < _n; i++)
+		{
+			const auto ii = i + _r;
+			const auto io = i - _r - 1;
+			sum += static_cast<float>(_in[((ii < _n) ? ii : __reflect101(ii, _n)) * _stride + c]);
+			sum -= static_cast<float>(_in[((io >= 0) ? io : __reflect101(io, _n)) * _stride + c]);
+			_out[i * _stride + c] = sum * scale;
+		}
+	}
+}
+
+// Description:
+// Vertical box blur of the columns [_x0, _x1) (in elements) with running sums.
+// Every column of the stripe keeps its own sum, so the rows are read sequentially.
+// If _src is not null, the result is written as _alpha * _src + _beta * blur into the 8-bit _dst.
+static void __boxColumns(const float* _in, std::size_t _in_step, float* _out, std::size_t _out_step, int _rows, int _x0, int _x1, int _r,
+	std::vector<float>& _sum, const cv::Mat* _src = nullptr, cv::Mat* _dst = nullptr, float _alpha = 0.f, float _beta = 1.f)
+{
+	const auto scale = 1.f / static_cast<float>(2 * _r + 1);
+	const auto nx = _x1 - _x0;
+	std::fill(_sum.begin(), _sum.begin() + nx, 0.f);
+
+	for (auto k = -_r; k <= _r; k++)
+	{
+		const auto p = _in + __reflect101(k, _rows) * _in_step + _x0;
+		for (auto x = 0; x < nx; x++)
+			_sum[x] += p[x];
+	}
+
+	for (auto y = 0; y < _rows; y++)
+	{
+		if (y > 0)
+		{
+			const auto pi = _in + __reflect101(y + _r, _rows) * _in_step + _x0;
+			const auto po = _in + __reflect101(y - _r - 1, _rows) * _in_step + _x0;
+			for (auto x = 0; x < nx; x++)
+				_sum[x] += pi[x] - po[x];
+		}
+
+		if (_dst)
+		{
+			const auto s = _src->ptr<uchar>(y) + _x0;
+			auto d = _dst->ptr<uchar>(y) + _x0;
+			for (auto x = 0; x < nx; x++)
+				d[x] = cv::saturate_cast<uchar>(_alpha * s[x] + _beta * _sum[x] * scale);
+		}
+		else
+		{
+			auto d = _out + y * _out_step + _x0;
+			for (auto x = 0; x < nx; x++)
+				d[x] = _sum[x] * scale;
+		}
+	}
+}
+
+auto fvkFastFilters::gaussianBlur(const cv::Mat& _src, cv::Mat& _dst, double _sigma) -> bool
+{
+	return unsharpMask(_src, _dst, _sigma, 0.0, 1.0);
+}
+
+auto fvkFastFilters::unsharpMask(const cv::Mat& _src, cv::Mat& _dst, double _sigma, double _alpha, double _beta, std::vector<float>* _buffer) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _src.channels() > 4 || _sigma <= 0)
+		return false;
+
+	int radii[3];
+	__boxRadii(_sigma, radii);
+
+	const auto w = _src.cols;
+	const auto h = _src.rows;
+	const auto cn = _src.channels();
+	const auto rowlen = static_cast<std::size_t>(w) * cn;
+
+	// the two intermediate float planes are kept by the caller if it gives a buffer,
+	// and the buffer of another frame size is released instead of only growing.
+	std::vector<float> local;
+	auto& planes = _buffer ? *_buffer : local;
+	const auto n = rowlen * h;
+	if (planes.size() != 2 * n)
+		std::vector<float>(2 * n).swap(planes);
+	const auto a = planes.data();
+	const auto b = planes.data() + n;
+
+	// horizontal passes, row by row.
+	cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& _range)
+	{
+		std::vector<float> t(rowlen);
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto row = a + y * rowlen;
+			__boxLine(_src.ptr<uchar>(y), row, w, cn, radii[0], cn);
+			__boxLine(row, t.data(), w, cn, radii[1], cn);
+			__boxLine(t.data(), row, w, cn, radii[2], cn);
+		}
+	});
+
+	// vertical passes in column stripes, the last pass writes the weighted output.
+	cv::Mat m(_src.size(), _src.type());
+	const auto stripe = 256;
+	const auto nstripes = static_cast<int>((rowlen + stripe - 1) / stripe);
+	cv::parallel_for_(cv::Range(0, nstripes), [&](const cv::Range& _range)
+	{
+		std::vector<float> sum(stripe);
+		for (auto s = _range.start; s < _range.end; s++)
+		{
+			const auto x0 = s * stripe;
+			const auto x1 = std::min(static_cast<int>(rowlen), x0 + stripe);
+			__boxColumns(a, rowlen, b, rowlen, h, x0, x1, radii[0], sum);
+			__boxColumns(b, rowlen, a, rowlen, h, x0, x1, radii[1], sum);
+			__boxColumns(a, rowlen, nullptr, 0, h, x0, x1, radii[2], sum, &_src, &m, static_cast<float>(_alpha), static_cast<float>(_beta));
+		}
+	});
+
+	_dst = m;
+	return true;
+}
+
+/************************************************************************/
+/* 3x3 integer convolution                                              */
+/************************************************************************/
+
+// Description:
+// Copies the row _y of _src (reflected) through the table _lut into _row, with one
+// reflected pixel on both sides, so the convolution loop has no border cases.
+static void __convolutionRow(const cv::Mat& _src, int _y, const uchar* _lut, short* _row)
+{
+	const auto w = _src.cols;
+	const auto cn = _src.channels();
+	const auto rowlen = w * cn;
+	const auto s = _src.ptr<uchar>(__reflect101(_y, _src.rows));
+	auto d = _row + cn;
+
+	if (_lut)
+	{
+		for (auto i = 0; i < rowlen; i++)
+			d[i] = _lut[s[i]];
+	}
+	else
+	{
+		for (auto i = 0; i < rowlen; i++)
+			d[i] = s[i];
+	}
+
+	const auto l = __reflect101(-1, w) * cn;
+	const auto r = __reflect101(w, w) * cn;
+	for (auto c = 0; c < cn; c++)
+	{
+		_row[c] = d[l + c];
+		d[rowlen + c] = d[r + c];
+	}
+}
+
+auto fvkFastFilters::convolve3x3(const cv::Mat& _src, cv::Mat& _dst, const int _kernel[9], int _delta, int _shift, const uchar* _lut) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _src.channels() > 4 || _shift < 0 || _shift > 16)
+		return false;
+
+	const auto h = _src.rows;
+	const auto cn = _src.channels();
+	const auto rowlen = _src.cols * cn;
+	const int k[9] = { _kernel[0], _kernel[1], _kernel[2], _kernel[3], _kernel[4], _kernel[5], _kernel[6], _kernel[7], _kernel[8] };
+	const auto bias = _delta * (1 << _shift) + (_shift > 0 ? 1 << (_shift - 1) : 0);
+
+	// the rows of a stripe depend on the source rows around it, so the output can not be in place.
+	cv::Mat m(_src.size(), _src.type());
+	cv::parallel_for_(cv::Range(0, h), [&](const cv::Range& _range)
+	{
+		// three padded rows that are rotated, so every source row is mapped once per stripe.
+		const auto padded = static_cast<std::size_t>(rowlen + 2 * cn);
+		std::vector<short> buffer(3 * padded);
+		short* rows[3] = { &buffer[0], &buffer[padded], &buffer[2 * padded] };
+		__convolutionRow(_src, _range.start - 1, _lut, rows[0]);
+		__convolutionRow(_src, _range.start, _lut, rows[1]);
+
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			__convolutionRow(_src, y + 1, _lut, rows[2]);
+
+			const short* a = rows[0] + cn;
+			const short* b = rows[1] + cn;
+			const short* c = rows[2] + cn;
+			auto d = m.ptr<uchar>(y);
+			for (auto i = 0; i < rowlen; i++)
+			{
+				const auto sum =
+					k[0] * a[i - cn] + k[1] * a[i] + k[2] * a[i + cn] +
+					k[3] * b[i - cn] + k[4] * b[i] + k[5] * b[i + cn] +
+					k[6] * c[i - cn] + k[7] * c[i] + k[8] * c[i + cn] + bias;
+				d[i] = static_cast<uchar>(__clamp(sum >> _shift, 0, 255));
+			}
+
+			std::rotate(rows, rows + 1, rows + 3);
+		}
+	});
+
+	_dst = m;
+	return true;
+}
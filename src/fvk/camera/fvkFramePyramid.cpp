@@ -0,0 +1,118 @@
+/*********************************************************************************
+created:	2026/10/23   02:15PM
+filename: 	fvkFramePyramid.cpp
+file base:	fvkFramePyramid
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that caches the downscaled copies of one frame, so the motion
+gate, the detection schedule and the face detectors that need the frame at the
+same width share one resize per frame. The copies are made on demand, each one
+from the smallest cached copy that is still big enough.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkFramePyramid.h>
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+using namespace R3D;
+
+// gray version of _src (a copy of the header if it is already gray).
+static void __toGray(const cv::Mat& _src, cv::Mat& _dst)
+{
+	if (_src.channels() == 3)
+		cv::cvtColor(_src, _dst, cv::COLOR_BGR2GRAY);
+	else if (_src.channels() == 4)
+		cv::cvtColor(_src, _dst, cv::COLOR_BGRA2GRAY);
+	else
+		_dst = _src;
+}
+
+fvkFramePyramid::fvkFramePyramid()
+{
+}
+
+fvkFramePyramid::fvkFramePyramid(const cv::Mat& _frame)
+{
+	reset(_frame);
+}
+
+void fvkFramePyramid::reset(const cv::Mat& _frame)
+{
+	m_frame = _frame;
+	m_framegray.release();
+	m_levels.clear();
+}
+
+auto fvkFramePyramid::isOf(const cv::Mat& _frame) const -> bool
+{
+	return !m_frame.empty() && m_frame.data == _frame.data && m_frame.size() == _frame.size() && m_frame.type() == _frame.type();
+}
+
+auto fvkFramePyramid::getLevels() const -> int
+{
+	return static_cast<int>(m_levels.size());
+}
+
+auto fvkFramePyramid::find(int _width) -> Level*
+{
+	for (auto& l : m_levels)
+	{
+		if (l.width == _width)
+			return &l;
+	}
+	return nullptr;
+}
+
+auto fvkFramePyramid::level(int _width) -> cv::Mat
+{
+	if (m_frame.empty() || _width >= m_frame.cols || _width <= 0)
+		return m_frame;
+
+	if (auto l = find(_width))
+		return l->image;
+
+	// the source is the smallest copy that is at least twice as wide, so the area
+	// interpolation still averages enough pixels, or the frame itself.
+	const cv::Mat* src = &m_frame;
+	for (const auto& l : m_levels)
+	{
+		if (l.width >= _width * 2)
+			src = &l.image;
+	}
+
+	Level l;
+	l.width = _width;
+	const auto h = std::max(1, (m_frame.rows * _width + m_frame.cols / 2) / m_frame.cols);
+	cv::resize(*src, l.image, cv::Size(_width, h), 0, 0, cv::INTER_AREA);
+
+	const auto it = std::find_if(m_levels.begin(), m_levels.end(), [_width](const Level& _l) { return _l.width < _width; });
+	return m_levels.insert(it, l)->image;
+}
+
+auto fvkFramePyramid::gray(int _width) -> cv::Mat
+{
+	if (m_frame.empty() || _width >= m_frame.cols || _width <= 0)
+	{
+		if (m_framegray.empty())
+			__toGray(m_frame, m_framegray);
+		return m_framegray;
+	}
+
+	level(_width);
+	auto l = find(_width);
+	if (l->gray.empty())
+		__toGray(l->image, l->gray);
+	return l->gray;
+}
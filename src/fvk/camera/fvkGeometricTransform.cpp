@@ -0,0 +1,188 @@
+/*********************************************************************************
+created:	2026/10/19   04:10PM
+filename: 	fvkGeometricTransform.cpp
+file base:	fvkGeometricTransform
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that combines zoom, flip and rotation of a frame into one
+affine transform and applies it with a single remap.
+The fixed-point remap tables are cached and only rebuilt when the frame size
+or one of the parameters changes.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkGeometricTransform.h>
+
+#include <opencv2/imgproc.hpp>
+#include <cmath>
+
+using namespace R3D;
+
+// Description:
+// 2x3 affine matrix [a b c; d e f] stored row by row.
+struct __Affine
+{
+	double m[6];
+};
+
+// Description:
+// Returns _l * _r, i.e. _r applied first.
+static __Affine __compose(const __Affine& _l, const __Affine& _r)
+{
+	const auto l = _l.m;
+	const auto r = _r.m;
+	return __Affine { {
+		l[0] * r[0] + l[1] * r[3], l[0] * r[1] + l[1] * r[4], l[0] * r[2] + l[1] * r[5] + l[2],
+		l[3] * r[0] + l[4] * r[3], l[3] * r[1] + l[4] * r[4], l[3] * r[2] + l[4] * r[5] + l[5] } };
+}
+
+static __Affine __invert(const __Affine& _a)
+{
+	const auto a = _a.m;
+	const auto det = a[0] * a[4] - a[1] * a[3];
+	const auto id = det != 0.0 ? 1.0 / det : 0.0;
+	const auto i0 = a[4] * id, i1 = -a[1] * id, i3 = -a[3] * id, i4 = a[0] * id;
+	return __Affine { { i0, i1, -(i0 * a[2] + i1 * a[5]), i3, i4, -(i3 * a[2] + i4 * a[5]) } };
+}
+
+fvkGeometricTransform::fvkGeometricTransform() :
+m_fliprows(false),
+m_flipcols(false),
+m_angle(0),
+m_border(cv::BORDER_REPLICATE)
+{
+}
+
+void fvkGeometricTransform::clear()
+{
+	m_map1.release();
+	m_map2.release();
+	m_srcsize = cv::Size();
+}
+
+void fvkGeometricTransform::build()
+{
+	const auto w = static_cast<double>(m_srcsize.width);
+	const auto h = static_cast<double>(m_srcsize.height);
+	const auto zw = static_cast<double>(m_zoomsize.width);
+	const auto zh = static_cast<double>(m_zoomsize.height);
+
+	// forward transform (source to destination pixel), step by step.
+	// zoom with the pixel center convention of cv::resize.
+	auto t = __Affine { { zw / w, 0, 0.5 * zw / w - 0.5, 0, zh / h, 0.5 * zh / h - 0.5 } };
+
+	if (m_fliprows)
+		t = __compose(__Affine { { 1, 0, 0, 0, -1, zh - 1 } }, t);
+	if (m_flipcols)
+		t = __compose(__Affine { { -1, 0, zw - 1, 0, 1, 0 } }, t);
+
+	m_dstsize = m_zoomsize;
+	m_border = cv::BORDER_REPLICATE;
+	if (m_angle == 90.)
+	{
+		t = __compose(__Affine { { 0, 1, 0, -1, 0, zw - 1 } }, t);
+		m_dstsize = cv::Size(m_zoomsize.height, m_zoomsize.width);
+	}
+	else if (m_angle == 180.)
+	{
+		t = __compose(__Affine { { -1, 0, zw - 1, 0, -1, zh - 1 } }, t);
+	}
+	else if (m_angle == 270.)
+	{
+		t = __compose(__Affine { { 0, -1, zh - 1, 1, 0, 0 } }, t);
+		m_dstsize = cv::Size(m_zoomsize.height, m_zoomsize.width);
+	}
+	else if (m_angle != 0)
+	{
+		// rotation around the center, shifted to the center of the bounding box.
+		const auto cen = cv::Point2d(zw / 2.0, zh / 2.0);
+		const auto rot = cv::getRotationMatrix2D(cen, m_angle, 1.0);
+		const auto bbox = cv::RotatedRect(cen, m_zoomsize, static_cast<float>(m_angle)).boundingRect();
+		t = __compose(__Affine { {
+			rot.at<double>(0, 0), rot.at<double>(0, 1), rot.at<double>(0, 2) + bbox.width / 2.0 - cen.x,
+			rot.at<double>(1, 0), rot.at<double>(1, 1), rot.at<double>(1, 2) + bbox.height / 2.0 - cen.y } }, t);
+		m_border = cv::BORDER_CONSTANT;
+	}
+
+	const auto inv = __invert(t);
+	const auto a = inv.m;
+
+	// a transform that maps pixel centers to pixel centers does not need interpolation.
+	auto integral = true;
+	for (auto i = 0; i < 6; i++)
+		integral = integral && std::abs(a[i] - std::round(a[i])) < 1e-9;
+
+	const auto dw = m_dstsize.width;
+	m_map1.create(m_dstsize, CV_16SC2);
+	if (integral)
+		m_map2.release();
+	else
+		m_map2.create(m_dstsize, CV_16UC1);
+
+	cv::parallel_for_(cv::Range(0, m_dstsize.height), [&](const cv::Range& _range)
+	{
+		const auto tab = static_cast<double>(cv::INTER_TAB_SIZE);
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			auto m1 = m_map1.ptr<short>(y);
+			auto m2 = integral ? nullptr : m_map2.ptr<ushort>(y);
+			for (auto x = 0; x < dw; x++)
+			{
+				const auto sx = a[0] * x + a[1] * y + a[2];
+				const auto sy = a[3] * x + a[4] * y + a[5];
+				if (integral)
+				{
+					m1[x * 2 + 0] = cv::saturate_cast<short>(cvRound(sx));
+					m1[x * 2 + 1] = cv::saturate_cast<short>(cvRound(sy));
+				}
+				else
+				{
+					// same fixed-point layout as cv::convertMaps.
+					const auto ix = cvRound(sx * tab);
+					const auto iy = cvRound(sy * tab);
+					m1[x * 2 + 0] = cv::saturate_cast<short>(ix >> cv::INTER_BITS);
+					m1[x * 2 + 1] = cv::saturate_cast<short>(iy >> cv::INTER_BITS);
+					m2[x] = static_cast<ushort>((iy & (cv::INTER_TAB_SIZE - 1)) * cv::INTER_TAB_SIZE + (ix & (cv::INTER_TAB_SIZE - 1)));
+				}
+			}
+		}
+	});
+}
+
+auto fvkGeometricTransform::apply(const cv::Mat& _src, cv::Mat& _dst, const cv::Size& _zoomed_size, bool _flip_rows, bool _flip_cols, double _angle) -> bool
+{
+	if (_src.empty() || _zoomed_size.width <= 0 || _zoomed_size.height <= 0)
+		return false;
+
+	if (_zoomed_size == _src.size() && !_flip_rows && !_flip_cols && _angle == 0)
+		return false;
+
+	if (m_map1.empty() || _src.size() != m_srcsize || _zoomed_size != m_zoomsize ||
+		_flip_rows != m_fliprows || _flip_cols != m_flipcols || _angle != m_angle)
+	{
+		m_srcsize = _src.size();
+		m_zoomsize = _zoomed_size;
+		m_fliprows = _flip_rows;
+		m_flipcols = _flip_cols;
+		m_angle = _angle;
+		build();
+	}
+
+	cv::Mat m;
+	if (m_map2.empty())
+		cv::remap(_src, m, m_map1, cv::noArray(), cv::INTER_NEAREST, m_border);
+	else
+		cv::remap(_src, m, m_map1, m_map2, cv::INTER_LINEAR, m_border);
+	_dst = m;
+	return true;
+}
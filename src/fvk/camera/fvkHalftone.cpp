@@ -0,0 +1,149 @@
+/*********************************************************************************
+created:	2026/10/19   06:30PM
+filename: 	fvkHalftone.cpp
+file base:	fvkHalftone
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that renders a frame as a pattern of colored dots (halftone).
+Every block of the frame becomes an anti-aliased dot with the mean color
+of the block.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkHalftone.h>
+
+#include <opencv2/imgproc.hpp>
+#include <vector>
+#include <algorithm>
+
+using namespace R3D;
+
+fvkHalftone::fvkHalftone() :
+m_block(0)
+{
+}
+
+void fvkHalftone::buildMask(const cv::Size& _size, int _block_size)
+{
+	cv::Mat cir(cv::Mat::zeros(_size, CV_8UC1));
+	for (auto i = 0; i < _size.height; i += _block_size)
+		for (auto j = 0; j < _size.width; j += _block_size)
+			cv::circle(cir, cv::Point(j + _block_size / 2, i + _block_size / 2), _block_size / 2 - 1, CV_RGB(255, 255, 255), -1, CV_AA);
+
+	// min-max normalization of the mask to [0, 1].
+	auto mn = 255, mx = 0;
+	for (auto y = 0; y < cir.rows; y++)
+	{
+		const auto p = cir.ptr<uchar>(y);
+		for (auto x = 0; x < cir.cols; x++)
+		{
+			mn = std::min(mn, static_cast<int>(p[x]));
+			mx = std::max(mx, static_cast<int>(p[x]));
+		}
+	}
+	const auto scale = mx > mn ? 32768.0 / (mx - mn) : 0.0;
+
+	m_weight.create(_size, CV_16UC1);
+	for (auto y = 0; y < cir.rows; y++)
+	{
+		const auto p = cir.ptr<uchar>(y);
+		auto w = m_weight.ptr<ushort>(y);
+		for (auto x = 0; x < cir.cols; x++)
+			w[x] = static_cast<ushort>(cvRound((p[x] - mn) * scale));
+	}
+
+	m_size = _size;
+	m_block = _block_size;
+}
+
+auto fvkHalftone::apply(const cv::Mat& _src, cv::Mat& _dst, int _block_size) -> bool
+{
+	if (_src.empty() || _src.depth() != CV_8U || _block_size < 2)
+		return false;
+
+	const auto cn = _src.channels();
+	if (cn != 1 && cn != 3 && cn != 4)
+		return false;
+
+	if (m_weight.empty() || _src.size() != m_size || _block_size != m_block)
+		buildMask(_src.size(), _block_size);
+
+	const auto w = _src.cols;
+	const auto h = _src.rows;
+	const auto b = _block_size;
+	const auto nbx = (w + b - 1) / b;
+	const auto nby = (h + b - 1) / b;
+
+	// every band of blocks is reduced to its means and written in the same task,
+	// so the frame is read and written once.
+	cv::Mat m(_src.size(), CV_8UC3);
+	cv::parallel_for_(cv::Range(0, nby), [&](const cv::Range& _range)
+	{
+		std::vector<int> sums(static_cast<std::size_t>(nbx) * 3);
+		std::vector<int> means(static_cast<std::size_t>(nbx) * 3);
+		for (auto by = _range.start; by < _range.end; by++)
+		{
+			const auto y0 = by * b;
+			const auto y1 = std::min(h, y0 + b);
+			std::fill(sums.begin(), sums.end(), 0);
+
+			for (auto y = y0; y < y1; y++)
+			{
+				const auto p = _src.ptr<uchar>(y);
+				for (auto x = 0; x < w; x++)
+				{
+					auto s = &sums[(x / b) * 3];
+					const auto q = p + x * cn;
+					if (cn == 1)
+					{
+						s[0] += q[0];
+					}
+					else
+					{
+						s[0] += q[0];
+						s[1] += q[1];
+						s[2] += q[2];
+					}
+				}
+			}
+
+			// rounded means, same as filling the block with cv::mean.
+			for (auto bx = 0; bx < nbx; bx++)
+			{
+				const auto count = (std::min(w, (bx + 1) * b) - bx * b) * (y1 - y0);
+				for (auto c = 0; c < 3; c++)
+				{
+					const auto sum = sums[bx * 3 + (cn == 1 ? 0 : c)];
+					means[bx * 3 + c] = (2 * sum + count) / (2 * count);
+				}
+			}
+
+			for (auto y = y0; y < y1; y++)
+			{
+				const auto wt = m_weight.ptr<ushort>(y);
+				auto d = m.ptr<uchar>(y);
+				for (auto x = 0; x < w; x++)
+				{
+					const auto mean = &means[(x / b) * 3];
+					const auto k = static_cast<int>(wt[x]);
+					d[x * 3 + 0] = static_cast<uchar>((mean[0] * k + (1 << 14)) >> 15);
+					d[x * 3 + 1] = static_cast<uchar>((mean[1] * k + (1 << 14)) >> 15);
+					d[x * 3 + 2] = static_cast<uchar>((mean[2] * k + (1 << 14)) >> 15);
+				}
+			}
+		}
+	});
+
+	_dst = m;
+	return true;
+}
@@ -19,17 +19,22 @@ purpose:	class to do some basic image processing.
 **********************************************************************************/
 
 #include <fvk/camera/fvkImageProcessing.h>
+#include <fvk/camera/fvkFastFilters.h>
+#include <fvk/camera/fvkDomainTransform.h>
+#include <fvk/camera/fvkEqualizer.h>
 
 using namespace R3D;
 
 fvkImageProcessing::fvkImageProcessing() :
 m_denoislevel(0),
 m_denoismethod(DenoisingMethod::Gaussian),
+m_denoisquality(FilterQuality::Exact),
 m_sharplevel(0),
 m_details(0),
 m_smoothness(0),
 m_pencilsketch(0),
 m_stylization(0),
+m_nprquality(FilterQuality::Exact),
 m_brigtness(0),
 m_contrast(0),
 m_colorcontrast(0),
@@ -49,8 +54,14 @@ m_zoomperc(100),
 m_flip(FlipDirection::None),
 m_isgray(false),
 m_isfacetrack(false),
+m_isfaceasync(true),
+m_ismultiface(false),
+m_faceseq(0),
+m_faceresult(~0ull),
 m_threshold(0),
-m_equalizelimit(0)
+m_equalizelimit(0),
+m_stagetimes(static_cast<std::size_t>(Stage::Output), 0.0),
+m_revision(0)
 {
 }
 
@@ -60,13 +71,17 @@ fvkImageProcessing::~fvkImageProcessing()
 
 void fvkImageProcessing::reset()
 {
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_denoislevel = 0;
 	m_denoismethod = DenoisingMethod::Gaussian;
+	m_denoisquality = FilterQuality::Exact;
 	m_sharplevel = 0;
 	m_details = 0;
 	m_smoothness = 0;
 	m_pencilsketch = 0;
 	m_stylization = 0;
+	m_nprquality = FilterQuality::Exact;
 	m_brigtness = 0;
 	m_contrast = 0;
 	m_colorcontrast = 0;
@@ -86,6 +101,8 @@ void fvkImageProcessing::reset()
 	m_flip = FlipDirection::None;
 	m_isgray = false;
 	m_isfacetrack = false;
+	m_isfaceasync = true;
+	m_ismultiface = false;
 	m_threshold = 0;
 	m_equalizelimit = 0;
 }
@@ -109,13 +126,35 @@ static cv::Size __resizeKeepAspectRatio(int _old_w, int _old_h, int _new_w, int
 	return cv::Size(_final_w, _final_h);
 }
 
-void fvkImageProcessing::setDenoisingFilter(cv::Mat& _img, int _value, fvkImageProcessing::DenoisingMethod _method)
+void fvkImageProcessing::setDenoisingFilter(cv::Mat& _img, int _value, fvkImageProcessing::DenoisingMethod _method, fvkImageProcessing::FilterQuality _quality)
 {
 	if (_img.empty() || _value < 2) return;
 
 	if (_value % 2 != 0)
 	{
 		cv::Mat m(_img.size(), _img.type());
+
+		// constant-time approximations, cv::medianBlur is already fast up to 5x5.
+		if (_quality == fvkImageProcessing::FilterQuality::Fast)
+		{
+			if (_method == fvkImageProcessing::DenoisingMethod::Median && _value > 5)
+			{
+				if (fvkFastFilters::medianFilter(_img, m, _value))
+				{
+					_img = m;
+					return;
+				}
+			}
+			else if (_method == fvkImageProcessing::DenoisingMethod::Bilateral)
+			{
+				if (fvkFastFilters::bilateralFilter(_img, m, _value * 2, _value / 2))
+				{
+					_img = m;
+					return;
+				}
+			}
+		}
+
 		if (_method == fvkImageProcessing::DenoisingMethod::Gaussian)
 			cv::GaussianBlur(_img, m, cv::Size(_value, _value), 0, 0);
 		else if (_method == fvkImageProcessing::DenoisingMethod::Blur)
@@ -135,10 +174,15 @@ void fvkImageProcessing::setDenoisingFilter(cv::Mat& _img, int _value, fvkImageP
 	}
 }
 
-void fvkImageProcessing::setWeightedFilter(cv::Mat& _img, int _value, double _alpha, double _beta)
+void fvkImageProcessing::setWeightedFilter(cv::Mat& _img, int _value, double _alpha, double _beta, std::vector<float>* _buffer)
 {
 	if (_img.empty() || _value == 0) return;
 
+	// the kernel of cv::GaussianBlur grows with sigma, so bigger sigmas use the
+	// stacked box blur whose cost is constant (the weighted sum is done in its last pass).
+	if (_value >= 4 && fvkFastFilters::unsharpMask(_img, _img, static_cast<double>(_value), _alpha, _beta, _buffer))
+		return;
+
 	cv::Mat m(_img.size(), _img.type());
 	cv::GaussianBlur(_img, m, cv::Size(0, 0), static_cast<double>(_value));
 	cv::addWeighted(_img, _alpha, m, _beta, 0, m);
@@ -152,9 +196,26 @@ void fvkImageProcessing::setWeightedFilter(cv::Mat& _img, int _value, double _al
 	_img = m;
 }
 
-void fvkImageProcessing::setNonPhotorealisticFilter(cv::Mat& _img, int _value, float _sigma, fvkImageProcessing::Filters _filter)
+void fvkImageProcessing::setNonPhotorealisticFilter(cv::Mat& _img, int _value, float _sigma, fvkImageProcessing::Filters _filter, fvkImageProcessing::FilterQuality _quality)
 {
 	if (_img.empty() || _value == 0) return;
+
+	if (_quality == fvkImageProcessing::FilterQuality::Fast)
+	{
+		// one engine per thread keeps its buffers between the frames.
+		static thread_local fvkDomainTransform dt;
+		auto done = false;
+		if (_filter == fvkImageProcessing::Filters::Details)
+			done = dt.detailEnhance(_img, _img, static_cast<float>(_value), _sigma);
+		if (_filter == fvkImageProcessing::Filters::Smoothing)
+			done = dt.edgePreservingFilter(_img, _img, static_cast<float>(_value), _sigma);
+		if (_filter == fvkImageProcessing::Filters::PencilSketch)
+			done = dt.pencilSketch(_img, _img, static_cast<float>(_value), _sigma, 0.03f);
+		if (_filter == fvkImageProcessing::Filters::Stylization)
+			done = dt.stylization(_img, _img, static_cast<float>(_value), _sigma);
+		if (done) return;
+	}
+
 	if (_img.channels() != 3) return;
 
 	cv::Mat m;
@@ -218,96 +279,43 @@ void fvkImageProcessing::setContrastFilter(cv::Mat& _img, int _value)
 	_img = m;
 }
 
-void fvkImageProcessing::setColorContrastFilter(cv::Mat& _img, int _value)
+// Description:
+// Applies the table to the color channels of an 8-bit image (the alpha channel is kept).
+static void __applyColorLut(cv::Mat& _img, const uchar _lut[256])
 {
-	if (_img.empty() || _value == 0) return;
-
-	auto value = std::pow(static_cast<float>(_value + 100) / 100.f, 2.f);
-
-	if (_img.channels() == 1)
+	cv::Mat m;
+	if (_img.channels() == 4)
 	{
-		cv::Mat m(_img.size(), _img.type());
-		for (auto y = 0; y < _img.rows; y++)
+		cv::Mat lut(1, 256, CV_8UC4);
+		auto p = lut.ptr<uchar>(0);
+		for (auto i = 0; i < 256; i++)
 		{
-			for (auto x = 0; x < _img.cols; x++)
-			{
-				auto p = static_cast<float>(_img.at<uchar>(cv::Point(x, y)));
-
-				p /= 255.f;
-				p -= 0.5f;
-				p *= value;
-				p += 0.5f;
-				p *= 255.f;
-
-				m.at<uchar>(cv::Point(x, y)) = static_cast<uchar>(p);
-			}
+			p[i * 4 + 0] = p[i * 4 + 1] = p[i * 4 + 2] = _lut[i];
+			p[i * 4 + 3] = static_cast<uchar>(i);
 		}
-		_img = m;
+		cv::LUT(_img, lut, m);
 	}
-	else if (_img.channels() == 3)
+	else
 	{
-		cv::Mat m(_img.size(), _img.type());
-		for (auto y = 0; y < _img.rows; y++)
-		{
-			for (auto x = 0; x < _img.cols; x++)
-			{
-				cv::Vec3f pixel = _img.at<cv::Vec3b>(cv::Point(x, y));
-
-				pixel.val[0] /= 255.f;
-				pixel.val[0] -= 0.5f;
-				pixel.val[0] *= value;
-				pixel.val[0] += 0.5f;
-				pixel.val[0] *= 255.f;
-
-				pixel.val[1] /= 255.f;
-				pixel.val[1] -= 0.5f;
-				pixel.val[1] *= value;
-				pixel.val[1] += 0.5f;
-				pixel.val[1] *= 255.f;
-
-				pixel.val[2] /= 255.f;
-				pixel.val[2] -= 0.5f;
-				pixel.val[2] *= value;
-				pixel.val[2] += 0.5f;
-				pixel.val[2] *= 255.f;
-
-				m.at<cv::Vec3b>(cv::Point(x, y)) = pixel;
-			}
-		}
-		_img = m;
+		cv::Mat lut(1, 256, CV_8UC1);
+		std::copy(_lut, _lut + 256, lut.ptr<uchar>(0));
+		cv::LUT(_img, lut, m);
 	}
-	else if (_img.channels() == 4)
-	{
-		cv::Mat m(_img.size(), _img.type());
-		for (auto y = 0; y < _img.rows; y++)
-		{
-			for (auto x = 0; x < _img.cols; x++)
-			{
-				cv::Vec4f pixel = _img.at<cv::Vec4b>(cv::Point(x, y));
-
-				pixel.val[0] /= 255.f;
-				pixel.val[0] -= 0.5f;
-				pixel.val[0] *= value;
-				pixel.val[0] += 0.5f;
-				pixel.val[0] *= 255.f;
-
-				pixel.val[1] /= 255.f;
-				pixel.val[1] -= 0.5f;
-				pixel.val[1] *= value;
-				pixel.val[1] += 0.5f;
-				pixel.val[1] *= 255.f;
+	_img = m;
+}
 
-				pixel.val[2] /= 255.f;
-				pixel.val[2] -= 0.5f;
-				pixel.val[2] *= value;
-				pixel.val[2] += 0.5f;
-				pixel.val[2] *= 255.f;
+void fvkImageProcessing::setColorContrastFilter(cv::Mat& _img, int _value)
+{
+	if (_img.empty() || _value == 0) return;
+	if (_img.depth() != CV_8U || _img.channels() == 2) return;
 
-				m.at<cv::Vec4b>(cv::Point(x, y)) = pixel;
-			}
-		}
-		_img = m;
-	}
+	// every channel only depends on its own value, so the float formula is
+	// evaluated once for the 256 values and the frame is a table lookup.
+	const auto value = std::pow(static_cast<float>(_value + 100) / 100.f, 2.f);
+	uchar lut[256];
+	for (auto i = 0; i < 256; i++)
+		lut[i] = cv::saturate_cast<uchar>((((static_cast<float>(i) / 255.f) - 0.5f) * value + 0.5f) * 255.f);
+	__applyColorLut(_img, lut);
 }
 
 void fvkImageProcessing::setSaturationFilter(cv::Mat& _img, int _value)
@@ -379,33 +387,78 @@ void fvkImageProcessing::setVibranceFilter(cv::Mat& _img, int _value)
 	}
 }
 
+// Description:
+// Computes the BGR to BGR hue rotation matrix in Q12 fixed point.
+// The rotation is done around the Y axis of the YIQ space, so the luma is kept.
+static void __hueRotationMatrix(double _degrees, int _m[9])
+{
+	// rows are Y, I, Q and columns are B, G, R.
+	static const double yiq[9] = {
+		0.114, 0.587, 0.299,
+		-0.322, -0.274, 0.596,
+		0.312, -0.523, 0.211 };
+
+	// inverse of the YIQ matrix (BGR from YIQ).
+	const auto det = yiq[0] * (yiq[4] * yiq[8] - yiq[5] * yiq[7]) - yiq[1] * (yiq[3] * yiq[8] - yiq[5] * yiq[6]) + yiq[2] * (yiq[3] * yiq[7] - yiq[4] * yiq[6]);
+	const double inv[9] = {
+		(yiq[4] * yiq[8] - yiq[5] * yiq[7]) / det, (yiq[2] * yiq[7] - yiq[1] * yiq[8]) / det, (yiq[1] * yiq[5] - yiq[2] * yiq[4]) / det,
+		(yiq[5] * yiq[6] - yiq[3] * yiq[8]) / det, (yiq[0] * yiq[8] - yiq[2] * yiq[6]) / det, (yiq[2] * yiq[3] - yiq[0] * yiq[5]) / det,
+		(yiq[3] * yiq[7] - yiq[4] * yiq[6]) / det, (yiq[1] * yiq[6] - yiq[0] * yiq[7]) / det, (yiq[0] * yiq[4] - yiq[1] * yiq[3]) / det };
+
+	// the hue of HSV goes from red to green to blue, which is clockwise in the IQ plane.
+	const auto t = -_degrees * CV_PI / 180.0;
+	const double rot[9] = {
+		1, 0, 0,
+		0, std::cos(t), -std::sin(t),
+		0, std::sin(t), std::cos(t) };
+
+	double ry[9];
+	for (auto i = 0; i < 3; i++)
+		for (auto j = 0; j < 3; j++)
+			ry[i * 3 + j] = rot[i * 3 + 0] * yiq[0 * 3 + j] + rot[i * 3 + 1] * yiq[1 * 3 + j] + rot[i * 3 + 2] * yiq[2 * 3 + j];
+
+	for (auto i = 0; i < 3; i++)
+		for (auto j = 0; j < 3; j++)
+			_m[i * 3 + j] = cvRound(4096.0 * (inv[i * 3 + 0] * ry[0 * 3 + j] + inv[i * 3 + 1] * ry[1 * 3 + j] + inv[i * 3 + 2] * ry[2 * 3 + j]));
+}
+
 void fvkImageProcessing::setHueFilter(cv::Mat& _img, int _value)
 {
 	if (_img.empty() || _value == 0) return;
+	if (_img.depth() != CV_8U || (_img.channels() != 3 && _img.channels() != 4)) return;
 
-	if (_img.channels() == 3)
+	// the value is in the units of the 8-bit HSV hue (2 degrees), and the
+	// matrix is only recomputed when the value changes.
+	static thread_local int cached_value = 0;
+	static thread_local int mat[9];
+	if (_value != cached_value)
 	{
-		cv::Mat m;
-		cv::cvtColor(_img, m, cv::ColorConversionCodes::COLOR_BGR2HSV);	// BGR to HSV
+		__hueRotationMatrix(2.0 * _value, mat);
+		cached_value = _value;
+	}
 
-		for (auto y = 0; y < m.rows; y++)
+	const auto cn = _img.channels();
+	const auto w = _img.cols;
+	const auto m = mat;
+	cv::Mat dst(_img.size(), _img.type());
+	cv::parallel_for_(cv::Range(0, _img.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
 		{
-			for (auto x = 0; x < m.cols; x++)
+			const auto s = _img.ptr<uchar>(y);
+			auto d = dst.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
 			{
-				cv::Vec3f pixel = m.at<cv::Vec3b>(cv::Point(x, y));
-
-				pixel.val[0] += _value;
-				if (pixel.val[0] < 0) 
-					pixel.val[0] = 0; 
-				else if (pixel.val[0] > 255) 
-					pixel.val[0] = 255;
-
-				m.at<cv::Vec3b>(cv::Point(x, y)) = pixel;
+				const int b = s[x * cn + 0], g = s[x * cn + 1], r = s[x * cn + 2];
+				d[x * cn + 0] = cv::saturate_cast<uchar>((m[0] * b + m[1] * g + m[2] * r + (1 << 11)) >> 12);
+				d[x * cn + 1] = cv::saturate_cast<uchar>((m[3] * b + m[4] * g + m[5] * r + (1 << 11)) >> 12);
+				d[x * cn + 2] = cv::saturate_cast<uchar>((m[6] * b + m[7] * g + m[8] * r + (1 << 11)) >> 12);
+				if (cn == 4)
+					d[x * 4 + 3] = s[x * 4 + 3];
 			}
 		}
-		cv::cvtColor(m, m, cv::ColorConversionCodes::COLOR_HSV2BGR);	// HSV back to BGR
-		_img = m;
-	}
+	});
+	_img = dst;
 }
 
 void fvkImageProcessing::setGammaFilter(cv::Mat& _img, int _value)
@@ -428,6 +481,153 @@ void fvkImageProcessing::setGammaFilter(cv::Mat& _img, int _value)
 }
 
 void fvkImageProcessing::setExposureFilter(cv::Mat& _img, int _value)
+{
+	if (_img.empty() || _value == 0) return;
+	if (_img.depth() != CV_8U || _img.channels() == 2) return;
+
+	// same formula as the reference, evaluated once for the 256 values.
+	const auto value = 1.f - static_cast<float>(_value) / 50.f;
+	const auto exposureFactor = std::pow(2.0f, -value);
+	uchar lut[256];
+	for (auto i = 0; i < 256; i++)
+	{
+		const auto p = static_cast<float>(((exposureFactor * (static_cast<float>(i) / 255.f)) - 0.5f) * 1.0 + 0.5f);
+		lut[i] = cv::saturate_cast<uchar>(p > 1.0f ? 255.0f : 255.0f * p);
+	}
+	__applyColorLut(_img, lut);
+}
+
+void fvkImageProcessing::setSepiaFilter(cv::Mat& _img, int _value)
+{
+	if (_img.empty() || _value == 0) return;
+	if (_img.depth() != CV_8U || _img.channels() != 3) return;
+
+	// Q12 coefficients. Every channel uses the channels computed before it (red, then green,
+	// then blue), which are kept with 4 fractional bits, and all the sums stay within 32 bits.
+	const auto v = static_cast<double>(_value) / 100.0;
+	auto q = [](double _c) { return cvRound(_c * 4096.0); };
+	const int kr[3] = { q(0.189 * v), q(0.769 * v), q(1.0 - 0.607 * v) };
+	const int kg[3] = { q(0.168 * v), q(1.0 - 0.314 * v), q(0.349 * v) };
+	const int kb[3] = { q(1.0 - 0.869 * v), q(0.534 * v), q(0.272 * v) };
+
+	const auto w = _img.cols;
+	cv::Mat m(_img.size(), _img.type());
+	cv::parallel_for_(cv::Range(0, _img.rows), [&](const cv::Range& _range)
+	{
+		for (auto y = _range.start; y < _range.end; y++)
+		{
+			const auto s = _img.ptr<uchar>(y);
+			auto d = m.ptr<uchar>(y);
+			for (auto x = 0; x < w; x++)
+			{
+				const int b = s[x * 3 + 0], g = s[x * 3 + 1], r = s[x * 3 + 2];
+				const auto r12 = std::min(kr[0] * b + kr[1] * g + kr[2] * r, 255 << 12);
+				const auto r4 = (r12 + (1 << 7)) >> 8;
+				const auto g16 = std::min(kg[2] * r4 + ((kg[0] * b + kg[1] * g) << 4), 255 << 16);
+				const auto g4 = (g16 + (1 << 11)) >> 12;
+				const auto b16 = std::min(kb[2] * r4 + kb[1] * g4 + ((kb[0] * b) << 4), 255 << 16);
+				d[x * 3 + 0] = static_cast<uchar>((b16 + (1 << 15)) >> 16);
+				d[x * 3 + 1] = static_cast<uchar>((g16 + (1 << 15)) >> 16);
+				d[x * 3 + 2] = static_cast<uchar>((r12 + (1 << 11)) >> 12);
+			}
+		}
+	});
+	_img = m;
+}
+
+void fvkImageProcessing::setColorContrastFilterReference(cv::Mat& _img, int _value)
+{
+	if (_img.empty() || _value == 0) return;
+
+	auto value = std::pow(static_cast<float>(_value + 100) / 100.f, 2.f);
+
+	if (_img.channels() == 1)
+	{
+		cv::Mat m(_img.size(), _img.type());
+		for (auto y = 0; y < _img.rows; y++)
+		{
+			for (auto x = 0; x < _img.cols; x++)
+			{
+				auto p = static_cast<float>(_img.at<uchar>(cv::Point(x, y)));
+
+				p /= 255.f;
+				p -= 0.5f;
+				p *= value;
+				p += 0.5f;
+				p *= 255.f;
+
+				m.at<uchar>(cv::Point(x, y)) = cv::saturate_cast<uchar>(p);
+			}
+		}
+		_img = m;
+	}
+	else if (_img.channels() == 3)
+	{
+		cv::Mat m(_img.size(), _img.type());
+		for (auto y = 0; y < _img.rows; y++)
+		{
+			for (auto x = 0; x < _img.cols; x++)
+			{
+				cv::Vec3f pixel = _img.at<cv::Vec3b>(cv::Point(x, y));
+
+				pixel.val[0] /= 255.f;
+				pixel.val[0] -= 0.5f;
+				pixel.val[0] *= value;
+				pixel.val[0] += 0.5f;
+				pixel.val[0] *= 255.f;
+
+				pixel.val[1] /= 255.f;
+				pixel.val[1] -= 0.5f;
+				pixel.val[1] *= value;
+				pixel.val[1] += 0.5f;
+				pixel.val[1] *= 255.f;
+
+				pixel.val[2] /= 255.f;
+				pixel.val[2] -= 0.5f;
+				pixel.val[2] *= value;
+				pixel.val[2] += 0.5f;
+				pixel.val[2] *= 255.f;
+
+				m.at<cv::Vec3b>(cv::Point(x, y)) = pixel;
+			}
+		}
+		_img = m;
+	}
+	else if (_img.channels() == 4)
+	{
+		cv::Mat m(_img.size(), _img.type());
+		for (auto y = 0; y < _img.rows; y++)
+		{
+			for (auto x = 0; x < _img.cols; x++)
+			{
+				cv::Vec4f pixel = _img.at<cv::Vec4b>(cv::Point(x, y));
+
+				pixel.val[0] /= 255.f;
+				pixel.val[0] -= 0.5f;
+				pixel.val[0] *= value;
+				pixel.val[0] += 0.5f;
+				pixel.val[0] *= 255.f;
+
+				pixel.val[1] /= 255.f;
+				pixel.val[1] -= 0.5f;
+				pixel.val[1] *= value;
+				pixel.val[1] += 0.5f;
+				pixel.val[1] *= 255.f;
+
+				pixel.val[2] /= 255.f;
+				pixel.val[2] -= 0.5f;
+				pixel.val[2] *= value;
+				pixel.val[2] += 0.5f;
+				pixel.val[2] *= 255.f;
+
+				m.at<cv::Vec4b>(cv::Point(x, y)) = pixel;
+			}
+		}
+		_img = m;
+	}
+}
+
+void fvkImageProcessing::setExposureFilterReference(cv::Mat& _img, int _value)
 {
 	if (_value == 0)
 		return;
@@ -445,10 +645,10 @@ void fvkImageProcessing::setExposureFilter(cv::Mat& _img, int _value)
 		{
 			for (auto x = 0; x < _img.cols; x++)
 			{
-				auto p = _img.at<uchar>(x, y) / 255.f;
+				auto p = _img.at<uchar>(cv::Point(x, y)) / 255.f;
 				p = (((p > 1.0f ? exposureFactor : p < 0.0f ? 0.0f : exposureFactor * p) - 0.5f) * 1.0) + 0.5f;
 				p = p > 1.0f ? 255.0f : p < 0.0f ? 0.0f : 255.0f * p;
-				m.at<uchar>(cv::Point(y, x)) = p;
+				m.at<uchar>(cv::Point(x, y)) = p;
 			}
 		}
 		_img = m;
@@ -507,7 +707,7 @@ void fvkImageProcessing::setExposureFilter(cv::Mat& _img, int _value)
 	}
 }
 
-void fvkImageProcessing::setSepiaFilter(cv::Mat& _img, int _value)
+void fvkImageProcessing::setSepiaFilterReference(cv::Mat& _img, int _value)
 {
 	if (_img.empty() || _value == 0) return;
 
@@ -533,6 +733,34 @@ void fvkImageProcessing::setSepiaFilter(cv::Mat& _img, int _value)
 	}
 }
 
+auto fvkImageProcessing::validatePointFilters(int _frames, const cv::Size& _size) -> int
+{
+	using Filter = void(*)(cv::Mat&, int);
+	struct Pair { Filter fast; Filter reference; int from; int to; };
+	const Pair filters[] = {
+		{ setColorContrastFilter, setColorContrastFilterReference, -100, 100 },
+		{ setExposureFilter, setExposureFilterReference, -100, 100 },
+		{ setSepiaFilter, setSepiaFilterReference, 1, 100 }
+	};
+
+	cv::RNG rng(0x5eed);
+	auto maxdiff = 0;
+	for (auto i = 0; i < _frames; i++)
+	{
+		cv::Mat frame(_size, i % 2 == 0 ? CV_8UC3 : CV_8UC1);
+		rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+		for (const auto& f : filters)
+		{
+			const auto value = rng.uniform(f.from, f.to + 1);
+			cv::Mat fast = frame.clone(), reference = frame.clone();
+			f.fast(fast, value);
+			f.reference(reference, value);
+			maxdiff = std::max(maxdiff, static_cast<int>(cv::norm(fast, reference, cv::NORM_INF)));
+		}
+	}
+	return maxdiff;
+}
+
 void fvkImageProcessing::setClipFilter(cv::Mat& _img, int _value)
 {
 	if (_img.empty() || _value == 0) return;
@@ -569,229 +797,346 @@ void fvkImageProcessing::setClipFilter(cv::Mat& _img, int _value)
 		_img = m;
 	}
 }
+void fvkImageProcessing::setEmbossFilter(cv::Mat& _img, bool _negative)
+{
+	if (_img.empty()) return;
+
+	static const int kernel[9] = {
+		-1, -1, 0,
+		-1, 0, 1,
+		0, 1, 1 };
+
+	uchar negative[256];
+	if (_negative)
+	{
+		for (auto i = 0; i < 256; i++)
+			negative[i] = static_cast<uchar>(255 - i);
+	}
+	if (fvkFastFilters::convolve3x3(_img, _img, kernel, 128, 0, _negative ? negative : nullptr))
+		return;
+
+	// other depths.
+	cv::Mat m;
+	if (_negative)
+		cv::bitwise_not(_img, _img);
+	cv::filter2D(_img, m, _img.depth(), cv::Mat(3, 3, CV_32S, const_cast<int*>(kernel)), cv::Point(-1, -1), 128);
+	_img = m;
+}
 void fvkImageProcessing::setEqualizeFilter(cv::Mat& _img, double _cliplimit, cv::Size _tile_grid_size)
 {
 	if (_img.empty() || _cliplimit == 0) return;
 
-	if (_img.channels() == 1)
+	// one equalizer per thread keeps its CLAHE object and buffers between the frames.
+	static thread_local fvkEqualizer eq;
+	eq.apply(_img, _cliplimit, _tile_grid_size);
+}
+
+static void __toGrayScale(cv::Mat& _frame)
+{
+	cv::Mat m;
+	if (_frame.channels() == 3)
 	{
-		cv::Mat m;
-		cv::Ptr<cv::CLAHE> p = cv::createCLAHE(_cliplimit, _tile_grid_size); // adaptive histogram equalization
-		p->apply(_img, m);
-		_img = m;
+		cv::cvtColor(_frame, m, cv::ColorConversionCodes::COLOR_BGR2GRAY);
+		_frame = m;
 	}
-	else if (_img.channels() == 3)
+	else if (_frame.channels() == 4)
 	{
-		cv::Mat m;
-		std::vector<cv::Mat> channels(3);
-		cv::cvtColor(_img, m, CV_BGR2YCrCb);	//change to YCrCb format
-		cv::split(m, channels);					// split the image into channels
-		cv::Ptr<cv::CLAHE> p = cv::createCLAHE(_cliplimit, _tile_grid_size);
-		p->apply(channels[0], channels[0]);
-		cv::merge(channels, m);					// merge 3 channels including the modified one
-		cv::cvtColor(m, m, CV_YCrCb2BGR);		// change to BGR format
-		_img = m;
+		cv::cvtColor(_frame, m, cv::ColorConversionCodes::COLOR_BGRA2GRAY);
+		_frame = m;
 	}
-	else if (_img.channels() == 4)
+}
+
+// Description:
+// Helper class that measures the time of consecutive stages.
+// The times of the stages from _first to _last are cleared, and every stage
+// accumulates the time until the next stage begins (or the clock is destroyed).
+class __StageClock
+{
+public:
+	using Stage = fvkImageProcessing::Stage;
+
+	__StageClock(std::vector<double>& _times, Stage _first, Stage _last) :
+		m_times(_times),
+		m_stage(_first),
+		m_tick(cv::getTickCount())
 	{
-		cv::Mat m;
-		std::vector<cv::Mat> channels(4);
-		cv::split(_img, channels);
-
-		std::vector<cv::Mat> channels3(3);
-		channels3[0] = channels[0];
-		channels3[1] = channels[1];
-		channels3[2] = channels[2];
-		cv::merge(channels3, m);
-
-		cv::cvtColor(m, m, CV_BGR2YCrCb);
-		cv::split(m, channels3);
-		cv::Ptr<cv::CLAHE> p = cv::createCLAHE(_cliplimit, _tile_grid_size);
-		p->apply(channels3[0], channels3[0]);
-		cv::merge(channels3, m);
-		cv::cvtColor(m, m, CV_YCrCb2BGR);
-		
-		cv::Mat dst(_img.size(), _img.type());
-		for (auto y = 0; y < m.rows; y++)
-		{
-			for (auto x = 0; x < m.cols; x++)
-			{
-				auto pixel = m.at<cv::Vec3b>(cv::Point(x, y));
-				auto p = cv::Vec4b(pixel.val[0], pixel.val[1], pixel.val[2], channels[3].at<uchar>(cv::Point(x, y)));
-				dst.at<cv::Vec4b>(cv::Point(x, y)) = p;
+		for (auto i = static_cast<int>(_first); i <= static_cast<int>(_last); i++)
+			m_times[i] = 0;
+	}
+	~__StageClock()
+	{
+		next(m_stage);
+	}
+	void next(Stage _stage)
+	{
+		const auto tick = cv::getTickCount();
+		m_times[static_cast<int>(m_stage)] += static_cast<double>(tick - m_tick) * 1000.0 / cv::getTickFrequency();
+		m_tick = tick;
+		m_stage = _stage;
+	}
 
-			}
-		}
+private:
+	std::vector<double>& m_times;
+	Stage m_stage;
+	int64 m_tick;
+};
+
+auto fvkImageProcessing::effectiveDenoisingLevel() const -> int
+{
+	if (m_reduction.denoise_level_max > 0 && m_denoislevel > m_reduction.denoise_level_max)
+		return m_reduction.denoise_level_max;
+	return m_denoislevel;
+}
+auto fvkImageProcessing::effectiveNonPhotorealisticQuality() const -> FilterQuality
+{
+	return m_reduction.fast_npr ? FilterQuality::Fast : m_nprquality;
+}
+auto fvkImageProcessing::effectiveFaceDetectionInterval() const -> int
+{
+	return std::max(5, m_reduction.face_detection_interval);
+}
 
-		_img = dst;
+auto fvkImageProcessing::isColorStage(Stage _stage) const -> bool
+{
+	// active stages whose gray output is not the same as doing them on the gray image.
+	// Only the stages that never clip a channel commute with the gray conversion: the
+	// gaussian and box blurs (weights that sum to one) and the negative. The others saturate
+	// every channel on its own (e.g. pure red with brightness 50 is not the gray of 50 + gray),
+	// so the frame becomes gray after them.
+	switch (_stage)
+	{
+	case Stage::FaceDetection:	return m_isfacetrack;	// keeps the templates of the tracker in one format.
+	case Stage::Denoising:		return effectiveDenoisingLevel() > 2 && m_denoismethod != DenoisingMethod::Gaussian && m_denoismethod != DenoisingMethod::Blur;
+	case Stage::Smoothness:		return m_smoothness > 0;
+	case Stage::Equalize:		return m_equalizelimit > 0;
+	case Stage::Sharpening:		return m_sharplevel > 0;
+	case Stage::Details:		return m_details > 0;
+	case Stage::PencilSketch:	return m_pencilsketch > 0;
+	case Stage::Stylization:	return m_stylization > 0;
+	case Stage::Brightness:		return m_brigtness != 0;
+	case Stage::Contrast:		return m_contrast != 0;
+	case Stage::ColorContrast:	return m_colorcontrast != 0;
+	case Stage::Saturation:		return m_saturation != 0;
+	case Stage::Vibrance:		return m_vibrance != 0;
+	case Stage::Hue:			return m_hue != 0;
+	case Stage::Exposure:		return m_exposure != 0;
+	case Stage::Gamma:			return m_gamma != 0;
+	case Stage::Sepia:			return m_sepia > 0;
+	case Stage::Clip:			return m_clip > 0;
+	case Stage::Emboss:			return m_isemboss;
+	case Stage::Dots:			return m_ndots > 5;
+	case Stage::ConvertColor:	return m_convertcolor >= 0;
+	default:					return false;
 	}
 }
 
+auto fvkImageProcessing::grayScaleStage() const -> Stage
+{
+	if (!m_isgray && m_threshold <= 0)
+		return Stage::Output;
+
+	// the frame becomes gray right after the last stage that needs the colors.
+	for (auto i = static_cast<int>(Stage::Output) - 1; i >= 0; i--)
+	{
+		if (isColorStage(static_cast<Stage>(i)))
+			return static_cast<Stage>(i + 1);
+	}
+	return Stage::Geometry;
+}
+
 void fvkImageProcessing::imageProcessing(cv::Mat& _frame)
 {
-	m_mutex.lock();
+	const auto face = preProcessing(_frame);
+	filterProcessing(_frame);
+	postProcessing(_frame, face, getTrackedFaces());
+}
+
+auto fvkImageProcessing::preProcessing(cv::Mat& _frame) -> cv::Rect
+{
+	fvkFramePyramid pyramid(_frame);
+	return preProcessing(_frame, pyramid);
+}
+
+auto fvkImageProcessing::preProcessing(cv::Mat& _frame, fvkFramePyramid& _pyramid) -> cv::Rect
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
 
-	if (m_zoomperc > 0 && m_zoomperc != 100)
+	// when the output is single-channel, the frame is converted to gray as early as
+	// possible so that the remaining stages only process one plane.
+	const auto graystage = grayScaleStage();
+	__StageClock clock(m_stagetimes, Stage::Geometry, Stage::FaceDetection);
+	auto stage = [&](Stage _stage)
 	{
-		auto s = __resizeKeepAspectRatio(_frame.cols, _frame.rows, static_cast<int>(static_cast<float>(_frame.cols * (m_zoomperc / 100.f))), static_cast<int>(static_cast<float>(_frame.rows * (m_zoomperc / 100.f))));
-		auto m = cv::Mat(cv::Mat::zeros(s, _frame.type()));
-		cv::resize(_frame, m, s, 0, 0, cv::InterpolationFlags::INTER_LINEAR);
-		_frame = m;
+		clock.next(_stage);
+		if (_stage == graystage)
+			__toGrayScale(_frame);
+	};
+
+	// zoom, flip and rotation are done in one pass with cached remap tables.
+	stage(Stage::Geometry);
+	if ((m_zoomperc > 0 && m_zoomperc != 100) || m_flip != FlipDirection::None || m_rotangle != 0)
+	{
+		auto s = _frame.size();
+		if (m_zoomperc > 0 && m_zoomperc != 100)
+			s = __resizeKeepAspectRatio(_frame.cols, _frame.rows, static_cast<int>(static_cast<float>(_frame.cols * (m_zoomperc / 100.f))), static_cast<int>(static_cast<float>(_frame.rows * (m_zoomperc / 100.f))));
+		const auto fliprows = m_flip == FlipDirection::Horizontal || m_flip == FlipDirection::Both;
+		const auto flipcols = m_flip == FlipDirection::Vertical || m_flip == FlipDirection::Both;
+		m_geometry.apply(_frame, _frame, s, fliprows, flipcols, m_rotangle);
 	}
 
-	if (m_flip != FlipDirection::None)
+	stage(Stage::FaceDetection);
+	if (!m_isfacetrack || !m_ismultiface)
+		m_faces.clear();
+	if (!m_isfacetrack)
+		return cv::Rect();
+
+	// the detector, its schedule and the motion gate share the copies of this frame.
+	if (!_pyramid.isOf(_frame))
+		_pyramid.reset(_frame);
+
+	// every face is tracked around its last position, and the full frame is searched on a schedule.
+	if (m_ismultiface)
 	{
-		cv::Mat m;
-		if (m_flip == FlipDirection::Horizontal)
-			cv::flip(_frame, m, 0);
-		else if (m_flip == FlipDirection::Vertical)
-			cv::flip(_frame, m, 1);
-		else if (m_flip == FlipDirection::Both)
-			cv::flip(_frame, m, -1);
-		_frame = m;
+		m_faces = m_mft.detect(_pyramid);
+		return m_faces.empty() ? cv::Rect() : m_faces.front().rect;
 	}
 
-	if (m_rotangle != 0)
+	// the cascade gets a downscaled copy of the scheduled frames on its own thread,
+	// and this frame gets the latest result.
+	if (m_isfaceasync)
 	{
-		cv::Mat m;
-		if (m_rotangle == 90.)
-		{
-			cv::transpose(_frame, m);
-			cv::flip(m, m, 0);
-		}
-		else if (m_rotangle == 180.)
+		auto& schedule = m_ft.schedule();
+		const auto result = m_aft.getResult();
+		if (result.seq != m_faceresult)
 		{
-			cv::flip(_frame, m, -1);
-		}
-		else if (m_rotangle == 270.)
-		{
-			cv::transpose(_frame, m);
-			cv::flip(m, m, 1);
-		}
-		else
-		{
-			const auto cen = cv::Point2d(static_cast<double>(_frame.cols) / 2.0, static_cast<double>(_frame.rows) / 2.0);
-			auto rot_mat = cv::getRotationMatrix2D(cen, m_rotangle, 1.0);
-			const auto bbox = cv::RotatedRect(cen, _frame.size(), float(m_rotangle)).boundingRect();
-			rot_mat.at<double>(0, 2) += bbox.width / 2.0 - cen.x;
-			rot_mat.at<double>(1, 2) += bbox.height / 2.0 - cen.y;
-			cv::warpAffine(_frame, m, rot_mat, _frame.size(), cv::InterpolationFlags::INTER_LINEAR);
+			m_faceresult = result.seq;
+			schedule.detected(result.found, result.rect);
 		}
+		if (schedule.next(_pyramid, effectiveFaceDetectionInterval()))
+			m_aft.submit(_pyramid, m_faceseq);
+		return m_aft.getRect(m_faceseq++);
+	}
+
+	m_ft.detect(_pyramid, effectiveFaceDetectionInterval());
+	return m_ft.get().getRect();
+}
+
+void fvkImageProcessing::filterProcessing(cv::Mat& _frame)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+
+	const auto graystage = grayScaleStage();
+	__StageClock clock(m_stagetimes, Stage::Denoising, Stage::ConvertColor);
+	auto stage = [&](Stage _stage)
+	{
+		clock.next(_stage);
+		if (_stage == graystage)
+			__toGrayScale(_frame);
+	};
+
+	// the filters run on a smaller frame when the processing scale is reduced,
+	// and the result is scaled back to the original size at the end.
+	const auto size = _frame.size();
+	const auto scaled = m_reduction.processing_scale > 0 && m_reduction.processing_scale < 100;
+	if (scaled)
+	{
+		cv::Mat m;
+		const auto f = m_reduction.processing_scale / 100.0;
+		cv::resize(_frame, m, cv::Size(), f, f, cv::INTER_AREA);
 		_frame = m;
 	}
 
-	if (m_isfacetrack)
-		m_ft.detect(_frame, 5);
+	const auto nprquality = effectiveNonPhotorealisticQuality();
+	const auto denoislevel = effectiveDenoisingLevel();
 
-	if (m_denoislevel > 2)
-		setDenoisingFilter(_frame, m_denoislevel, m_denoismethod);
+	stage(Stage::Denoising);
+	if (denoislevel > 2)
+		setDenoisingFilter(_frame, denoislevel, m_denoismethod, m_denoisquality);
 
+	stage(Stage::Smoothness);
 	if (m_smoothness > 0)
-		setNonPhotorealisticFilter(_frame, m_smoothness, 0.1f, fvkImageProcessing::Filters::Smoothing);
+		setNonPhotorealisticFilter(_frame, m_smoothness, 0.1f, fvkImageProcessing::Filters::Smoothing, nprquality);
 
+	stage(Stage::Equalize);
 	if (m_equalizelimit > 0)
-		setEqualizeFilter(_frame, m_equalizelimit, cv::Size(8, 8));
+		m_equalizer.apply(_frame, m_equalizelimit, cv::Size(8, 8));
 
+	stage(Stage::Sharpening);
 	if (m_sharplevel > 0)
-		setWeightedFilter(_frame, m_sharplevel, 1.5, -0.5);
+		setWeightedFilter(_frame, m_sharplevel, 1.5, -0.5, &m_sharpenplanes);
+	else if (!m_sharpenplanes.empty())
+		std::vector<float>().swap(m_sharpenplanes);
 
+	stage(Stage::Details);
 	if (m_details > 0)
-		setNonPhotorealisticFilter(_frame, m_details, 0.02f, fvkImageProcessing::Filters::Details);
+		setNonPhotorealisticFilter(_frame, m_details, 0.02f, fvkImageProcessing::Filters::Details, nprquality);
 
+	stage(Stage::PencilSketch);
 	if (m_pencilsketch > 0)
-		setNonPhotorealisticFilter(_frame, m_pencilsketch, 0.1f, fvkImageProcessing::Filters::PencilSketch);
+		setNonPhotorealisticFilter(_frame, m_pencilsketch, 0.1f, fvkImageProcessing::Filters::PencilSketch, nprquality);
 
+	stage(Stage::Stylization);
 	if (m_stylization > 0)
-		setNonPhotorealisticFilter(_frame, m_stylization, 0.45f, fvkImageProcessing::Filters::Stylization);
+		setNonPhotorealisticFilter(_frame, m_stylization, 0.45f, fvkImageProcessing::Filters::Stylization, nprquality);
 
+	stage(Stage::Brightness);
 	if (m_brigtness != 0)
 		setBrightnessFilter(_frame, m_brigtness);
 
+	stage(Stage::Contrast);
 	if (m_contrast != 0)
 		setContrastFilter(_frame, m_contrast);
 
+	stage(Stage::ColorContrast);
 	if (m_colorcontrast != 0)
 		setColorContrastFilter(_frame, m_colorcontrast);
 
+	stage(Stage::Saturation);
 	if (m_saturation != 0)
 		setSaturationFilter(_frame, m_saturation);
 
+	stage(Stage::Vibrance);
 	if (m_vibrance != 0)
 		setVibranceFilter(_frame, m_vibrance);
 
+	stage(Stage::Hue);
 	if (m_hue != 0)
 		setHueFilter(_frame, m_hue);
 
+	stage(Stage::Exposure);
 	if (m_exposure != 0)
 		setExposureFilter(_frame, m_exposure);
 
+	stage(Stage::Gamma);
 	if (m_gamma != 0)
 		setGammaFilter(_frame, m_gamma);
 
+	stage(Stage::Sepia);
 	if (m_sepia > 0)
 		setSepiaFilter(_frame, m_sepia);
 
+	stage(Stage::Clip);
 	if (m_clip > 0)
 		setClipFilter(_frame, m_clip);
 
-	if (m_isnegative)
+	// the negative is done by the emboss convolution when both are enabled (counted in Emboss).
+	stage(Stage::Negative);
+	if (m_isnegative && !m_isemboss)
 	{
 		cv::Mat m;
 		cv::bitwise_not(_frame, m);
 		_frame = m;
 	}
 
+	stage(Stage::Emboss);
 	if (m_isemboss)
-	{
-		cv::Mat kern = (cv::Mat_<char>(3, 3) <<
-			-1, -1, 0,
-			-1, 0, 1,
-			0, 1, 1);
-		cv::Mat m;
-		cv::filter2D(_frame, m, _frame.depth(), kern, cv::Point(-1, -1), 128);
-		_frame = m;
-	}
+		setEmbossFilter(_frame, m_isnegative);
 
+	stage(Stage::Dots);
 	if (m_ndots > 5)
-	{
-		if (_frame.channels() == 4)
-			cv::cvtColor(_frame, _frame, cv::ColorConversionCodes::COLOR_BGRA2BGR);
-		else if (_frame.channels() == 1)
-			cv::cvtColor(_frame, _frame, cv::ColorConversionCodes::COLOR_GRAY2BGR);
-
-		auto dst = cv::Mat(cv::Mat::zeros(_frame.size(), CV_8UC3));
-		auto cir = cv::Mat(cv::Mat::zeros(_frame.size(), CV_8UC1));
-		auto bsize = m_ndots;
-
-		for (auto i = 0; i < _frame.rows; i += bsize)
-		{
-			for (auto j = 0; j < _frame.cols; j += bsize)
-			{
-				auto rect = cv::Rect(j, i, bsize, bsize) & cv::Rect(0, 0, _frame.cols, _frame.rows);
-				auto sub_dst = cv::Mat(dst, rect);
-				sub_dst.setTo(cv::mean(_frame(rect)));
-				cv::circle(cir, cv::Point(j + bsize / 2, i + bsize / 2), bsize / 2 - 1, CV_RGB(255, 255, 255), -1, CV_AA);
-			}
-		}
-
-		cv::Mat cir_32f;
-		cir.convertTo(cir_32f, CV_32F);
-		cv::normalize(cir_32f, cir_32f, 0, 1, cv::NORM_MINMAX);
-
-		cv::Mat dst_32f;
-		dst.convertTo(dst_32f, CV_32F);
-
-		std::vector<cv::Mat> channels;
-		cv::split(dst_32f, channels);
-		for (size_t i = 0; i < channels.size(); ++i)
-			channels[i] = channels[i].mul(cir_32f);
-
-		cv::merge(channels, dst_32f);
-		dst_32f.convertTo(dst, CV_8U);
-
-		_frame = dst;
-	}
+		m_halftone.apply(_frame, _frame, m_ndots);
 
+	stage(Stage::ConvertColor);
 	if (m_convertcolor >= 0)
 	{
 		cv::Mat m;
@@ -800,23 +1145,11 @@ void fvkImageProcessing::imageProcessing(cv::Mat& _frame)
 	}
 
 	if (m_isgray)
-	{
-		cv::Mat m;
-		if (_frame.channels() == 3)
-		{
-			cv::cvtColor(_frame, m, cv::ColorConversionCodes::COLOR_BGR2GRAY);
-			_frame = m;
-		}
-		else if (_frame.channels() == 4)
-		{
-			cv::cvtColor(_frame, m, cv::ColorConversionCodes::COLOR_BGRA2GRAY);
-			_frame = m;
-		}
-	}
+		__toGrayScale(_frame);
 
 	if (m_threshold > 0)
 	{
-		cv::Mat m;
+		cv::Mat m = _frame;
 		if (_frame.channels() == 3)
 			cv::cvtColor(_frame, m, CV_BGR2GRAY);
 		else if (_frame.channels() == 4)
@@ -826,15 +1159,105 @@ void fvkImageProcessing::imageProcessing(cv::Mat& _frame)
 		_frame = m;
 	}
 
-	if(m_isfacetrack)
-		cv::rectangle(_frame, m_ft.get().getRect(), cv::Vec3b(166, 154, 75));
+	if (scaled)
+	{
+		cv::Mat m;
+		cv::resize(_frame, m, size, 0, 0, cv::INTER_LINEAR);
+		_frame = m;
+	}
 
-	m_mutex.unlock();
+}
+
+void fvkImageProcessing::postProcessing(cv::Mat& _frame, const cv::Rect& _face, const std::vector<fvkTrackedFace>& _faces)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+
+	if (!m_isfacetrack)
+		return;
+
+	if (_faces.empty())
+	{
+		cv::rectangle(_frame, _face, cv::Vec3b(166, 154, 75));
+		return;
+	}
+
+	// the faces that are only followed by template matching are drawn in another color.
+	for (const auto& f : _faces)
+		cv::rectangle(_frame, f.rect, f.lost ? cv::Vec3b(75, 154, 166) : cv::Vec3b(166, 154, 75));
+}
+
+void fvkImageProcessing::copySettings(fvkImageProcessing& _other)
+{
+	if (&_other == this)
+		return;
+
+	std::lock(m_mutex, _other.m_mutex);
+	std::lock_guard<std::mutex> locker(m_mutex, std::adopt_lock);
+	std::lock_guard<std::mutex> other_locker(_other.m_mutex, std::adopt_lock);
+
+	m_denoislevel = _other.m_denoislevel;
+	m_denoismethod = _other.m_denoismethod;
+	m_denoisquality = _other.m_denoisquality;
+	m_sharplevel = _other.m_sharplevel;
+	m_smoothness = _other.m_smoothness;
+	m_details = _other.m_details;
+	m_pencilsketch = _other.m_pencilsketch;
+	m_stylization = _other.m_stylization;
+	m_nprquality = _other.m_nprquality;
+	m_brigtness = _other.m_brigtness;
+	m_contrast = _other.m_contrast;
+	m_colorcontrast = _other.m_colorcontrast;
+	m_saturation = _other.m_saturation;
+	m_vibrance = _other.m_vibrance;
+	m_hue = _other.m_hue;
+	m_gamma = _other.m_gamma;
+	m_exposure = _other.m_exposure;
+	m_sepia = _other.m_sepia;
+	m_clip = _other.m_clip;
+	m_ndots = _other.m_ndots;
+	m_isemboss = _other.m_isemboss;
+	m_rotangle = _other.m_rotangle;
+	m_isnegative = _other.m_isnegative;
+	m_zoomperc = _other.m_zoomperc;
+	m_flip = _other.m_flip;
+	m_isgray = _other.m_isgray;
+	m_convertcolor = _other.m_convertcolor;
+	m_threshold = _other.m_threshold;
+	m_equalizelimit = _other.m_equalizelimit;
+	m_isfacetrack = _other.m_isfacetrack;
+	m_isfaceasync = _other.m_isfaceasync;
+	m_ismultiface = _other.m_ismultiface;
+	m_reduction = _other.m_reduction;
+	m_revision = _other.m_revision;
+}
+auto fvkImageProcessing::getSettingsRevision() -> unsigned
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_revision;
+}
+
+auto fvkImageProcessing::getStageTimes() -> std::vector<double>
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_stagetimes;
+}
+
+void fvkImageProcessing::setQualityReduction(const QualityReduction& _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
+	m_reduction = _value;
+}
+auto fvkImageProcessing::getQualityReduction() -> QualityReduction
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_reduction;
 }
 
 void fvkImageProcessing::setDenoisingMethod(fvkImageProcessing::DenoisingMethod _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_denoismethod = _value;
 }
 auto fvkImageProcessing::getDenoisingMethod() -> fvkImageProcessing::DenoisingMethod
@@ -845,6 +1268,7 @@ auto fvkImageProcessing::getDenoisingMethod() -> fvkImageProcessing::DenoisingMe
 void fvkImageProcessing::setDenoisingLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_denoislevel = _value;
 }
 auto fvkImageProcessing::getDenoisingLevel() -> int
@@ -852,10 +1276,22 @@ auto fvkImageProcessing::getDenoisingLevel() -> int
 	std::lock_guard<std::mutex> locker(m_mutex);
 	return m_denoislevel;
 }
+void fvkImageProcessing::setDenoisingQuality(FilterQuality _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
+	m_denoisquality = _value;
+}
+auto fvkImageProcessing::getDenoisingQuality() -> FilterQuality
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_denoisquality;
+}
 
 void fvkImageProcessing::setSharpeningLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_sharplevel = _value;
 }
 auto fvkImageProcessing::getSharpeningLevel() -> int
@@ -867,6 +1303,7 @@ auto fvkImageProcessing::getSharpeningLevel() -> int
 void fvkImageProcessing::setDetailLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_details = _value;
 }
 auto fvkImageProcessing::getDetailLevel() -> int
@@ -877,6 +1314,7 @@ auto fvkImageProcessing::getDetailLevel() -> int
 void fvkImageProcessing::setSmoothness(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_smoothness = _value;
 }
 auto fvkImageProcessing::getSmoothness() -> int
@@ -887,6 +1325,7 @@ auto fvkImageProcessing::getSmoothness() -> int
 void fvkImageProcessing::setPencilSketchLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_pencilsketch = _value;
 }
 auto fvkImageProcessing::getPencilSketchLevel() -> int
@@ -897,6 +1336,7 @@ auto fvkImageProcessing::getPencilSketchLevel() -> int
 void fvkImageProcessing::setStylizationLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_stylization = _value;
 }
 auto fvkImageProcessing::getStylizationLevel() -> int
@@ -904,10 +1344,22 @@ auto fvkImageProcessing::getStylizationLevel() -> int
 	std::lock_guard<std::mutex> locker(m_mutex);
 	return m_stylization;
 }
+void fvkImageProcessing::setNonPhotorealisticQuality(FilterQuality _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
+	m_nprquality = _value;
+}
+auto fvkImageProcessing::getNonPhotorealisticQuality() -> FilterQuality
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_nprquality;
+}
 
 void fvkImageProcessing::setBrightness(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_brigtness = _value;
 }
 auto fvkImageProcessing::getBrightness() -> int
@@ -919,6 +1371,7 @@ auto fvkImageProcessing::getBrightness() -> int
 void fvkImageProcessing::setContrast(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_contrast = _value;
 }
 auto fvkImageProcessing::getContrast() -> int
@@ -930,6 +1383,7 @@ auto fvkImageProcessing::getContrast() -> int
 void fvkImageProcessing::setColorContrast(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_colorcontrast = _value;
 }
 auto fvkImageProcessing::getColorContrast() -> int
@@ -941,6 +1395,7 @@ auto fvkImageProcessing::getColorContrast() -> int
 void fvkImageProcessing::setSaturation(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_saturation = _value;
 }
 auto fvkImageProcessing::getSaturation() -> int
@@ -952,6 +1407,7 @@ auto fvkImageProcessing::getSaturation() -> int
 void fvkImageProcessing::setVibrance(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_vibrance = _value;
 }
 auto fvkImageProcessing::getVibrance() -> int
@@ -963,6 +1419,7 @@ auto fvkImageProcessing::getVibrance() -> int
 void fvkImageProcessing::setHue(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_hue = _value;
 }
 auto fvkImageProcessing::getHue() -> int
@@ -974,6 +1431,7 @@ auto fvkImageProcessing::getHue() -> int
 void fvkImageProcessing::setGamma(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_gamma = _value;
 }
 auto fvkImageProcessing::getGamma() -> int
@@ -984,6 +1442,7 @@ auto fvkImageProcessing::getGamma() -> int
 void fvkImageProcessing::setExposure(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_exposure = _value;
 }
 auto fvkImageProcessing::getExposure() -> int
@@ -995,6 +1454,7 @@ auto fvkImageProcessing::getExposure() -> int
 void fvkImageProcessing::setSepia(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_sepia = _value;
 }
 auto fvkImageProcessing::getSepia() -> int
@@ -1006,6 +1466,7 @@ auto fvkImageProcessing::getSepia() -> int
 void fvkImageProcessing::setClip(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_clip = _value;
 }
 auto fvkImageProcessing::getClip() -> int
@@ -1017,6 +1478,7 @@ auto fvkImageProcessing::getClip() -> int
 void fvkImageProcessing::setNegativeModeEnabled(bool _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_isnegative = _value;
 }
 auto fvkImageProcessing::isNegativeModeEnabled() -> bool
@@ -1028,6 +1490,7 @@ auto fvkImageProcessing::isNegativeModeEnabled() -> bool
 void fvkImageProcessing::setLightEmbossEnabled(bool _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_isemboss = _value;
 }
 auto fvkImageProcessing::isLightEmbossEnabled() -> bool
@@ -1039,6 +1502,7 @@ auto fvkImageProcessing::isLightEmbossEnabled() -> bool
 void fvkImageProcessing::setDotPatternLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_ndots = _value;
 }
 auto fvkImageProcessing::getDotPatternLevel() -> int
@@ -1050,6 +1514,7 @@ auto fvkImageProcessing::getDotPatternLevel() -> int
 void fvkImageProcessing::setFlipDirection(FlipDirection _d)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_flip = _d;
 }
 auto fvkImageProcessing::getFlipDirection() -> fvkImageProcessing::FlipDirection
@@ -1061,6 +1526,7 @@ auto fvkImageProcessing::getFlipDirection() -> fvkImageProcessing::FlipDirection
 void fvkImageProcessing::setZoomLevel(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_zoomperc = _value;
 }
 auto fvkImageProcessing::getZoomLevel() -> int
@@ -1072,6 +1538,7 @@ auto fvkImageProcessing::getZoomLevel() -> int
 void fvkImageProcessing::setRotationAngle(double _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_rotangle = _value;
 }
 auto fvkImageProcessing::getRotationAngle() -> double
@@ -1083,6 +1550,7 @@ auto fvkImageProcessing::getRotationAngle() -> double
 void fvkImageProcessing::setConvertColor(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_convertcolor = _value;
 }
 auto fvkImageProcessing::getConvertColor() -> int
@@ -1094,6 +1562,7 @@ auto fvkImageProcessing::getConvertColor() -> int
 void fvkImageProcessing::setGrayScaleEnabled(bool _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_isgray = _value;
 }
 auto fvkImageProcessing::isGrayScaleEnabled() -> bool
@@ -1105,6 +1574,7 @@ auto fvkImageProcessing::isGrayScaleEnabled() -> bool
 void fvkImageProcessing::setThresholdValue(int _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_threshold = _value;
 }
 auto fvkImageProcessing::getThresholdValue() -> int
@@ -1115,6 +1585,7 @@ auto fvkImageProcessing::getThresholdValue() -> int
 void fvkImageProcessing::setEqualizeClipLimit(double _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_equalizelimit = _value;
 }
 auto fvkImageProcessing::getEqualizeClipLimit() -> double
@@ -1128,15 +1599,51 @@ auto fvkImageProcessing::getEqualizeClipLimit() -> double
 /************************************************************************/
 auto fvkImageProcessing::loadCascadeClassifier(const std::string& _filename) -> bool
 {
-	return m_ft.loadCascadeClassifier(_filename);
+	return m_ft.loadCascadeClassifier(_filename) && m_aft.loadCascadeClassifier(_filename) && m_mft.loadCascadeClassifier(_filename);
+}
+auto fvkImageProcessing::loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool
+{
+	return m_ft.loadFaceDetector(_type, _filename) && m_aft.loadFaceDetector(_type, _filename) && m_mft.loadFaceDetector(_type, _filename);
 }
 void fvkImageProcessing::setFaceDetectionEnabled(bool _value)
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
 	m_isfacetrack = _value;
 }
 auto fvkImageProcessing::isFaceDetectionEnabled() -> bool
 {
 	std::lock_guard<std::mutex> locker(m_mutex);
 	return m_isfacetrack;
+}
+void fvkImageProcessing::setAsyncFaceDetectionEnabled(bool _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
+	m_isfaceasync = _value;
+	if (!_value)
+		m_aft.stop();
+}
+auto fvkImageProcessing::isAsyncFaceDetectionEnabled() -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_isfaceasync;
+}
+void fvkImageProcessing::setMultiFaceTrackingEnabled(bool _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_revision++;
+	m_ismultiface = _value;
+	if (!_value)
+		m_mft.reset();
+}
+auto fvkImageProcessing::isMultiFaceTrackingEnabled() -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_ismultiface;
+}
+auto fvkImageProcessing::getTrackedFaces() -> std::vector<fvkTrackedFace>
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_faces;
 }
\ No newline at end of file
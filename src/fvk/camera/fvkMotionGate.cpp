@@ -0,0 +1,145 @@
+/*********************************************************************************
+created:	2026/10/20   02:05PM
+filename: 	fvkMotionGate.cpp
+file base:	fvkMotionGate
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that detects static frames cheaply, so that the processing
+thread can reuse the previous processed frame instead of processing them again.
+A small gray thumbnail of every frame is compared (sum of absolute differences)
+with the thumbnail of the last processed frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkMotionGate.h>
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+using namespace R3D;
+
+static const int THUMBNAIL_WIDTH = 96;	// width of the thumbnails.
+static const int BLOCK_SIZE = 8;		// size of the thumbnail blocks.
+
+fvkMotionGate::fvkMotionGate() :
+m_enabled(false),
+m_mean(1.5),
+m_block(6),
+m_maxskip(100),
+m_revision(0)
+{
+}
+
+void fvkMotionGate::setEnabled(bool _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_enabled = _value;
+	m_ref.release();
+}
+auto fvkMotionGate::isEnabled() const -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_enabled;
+}
+
+void fvkMotionGate::setThresholds(double _mean, double _block)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_mean = _mean;
+	m_block = _block;
+}
+auto fvkMotionGate::getMeanThreshold() const -> double
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_mean;
+}
+auto fvkMotionGate::getBlockThreshold() const -> double
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_block;
+}
+
+void fvkMotionGate::setMaxSkippedFrames(int _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_maxskip = _value;
+}
+auto fvkMotionGate::getMaxSkippedFrames() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_maxskip;
+}
+
+void fvkMotionGate::reset()
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_ref.release();
+}
+
+auto fvkMotionGate::getStats() const -> fvkMotionStats
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_stats;
+}
+
+auto fvkMotionGate::isStatic(const cv::Mat& _frame, unsigned _revision) -> bool
+{
+	fvkFramePyramid pyramid(_frame);
+	return isStatic(pyramid, _revision);
+}
+
+auto fvkMotionGate::isStatic(fvkFramePyramid& _pyramid, unsigned _revision) -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+
+	const auto& frame = _pyramid.frame();
+	if (!m_enabled || frame.empty() || frame.depth() != CV_8U)
+		return false;
+
+	// the thumbnail is made before the gray conversion, so only a few pixels are converted.
+	// It is only read, because it is shared with the other users of the pyramid.
+	m_thumb = _pyramid.gray(THUMBNAIL_WIDTH);
+	if (m_thumb.data == frame.data)
+		m_thumb = m_thumb.clone();	// a small gray frame is its own thumbnail, and it is kept as the reference.
+	const auto w = m_thumb.cols;
+	const auto h = m_thumb.rows;
+
+	auto skip = !m_ref.empty() && m_ref.size() == m_thumb.size() && _revision == m_revision &&
+		(m_maxskip <= 0 || m_stats.consecutive < m_maxskip);
+
+	if (skip)
+	{
+		cv::absdiff(m_thumb, m_ref, m_diff);
+		m_stats.difference = cv::mean(m_diff)[0];
+
+		// the block means are the pixels of the difference reduced by the block size.
+		cv::resize(m_diff, m_blocks, cv::Size((w + BLOCK_SIZE - 1) / BLOCK_SIZE, (h + BLOCK_SIZE - 1) / BLOCK_SIZE), 0, 0, cv::INTER_AREA);
+		cv::minMaxLoc(m_blocks, nullptr, &m_stats.block_difference);
+
+		skip = m_stats.difference <= m_mean && m_stats.block_difference <= m_block;
+	}
+
+	if (skip)
+	{
+		m_stats.skipped++;
+		m_stats.consecutive++;
+		return true;
+	}
+
+	// this frame will be processed and becomes the reference of the next frames.
+	std::swap(m_ref, m_thumb);
+	m_revision = _revision;
+	m_stats.processed++;
+	m_stats.consecutive = 0;
+	return false;
+}
@@ -0,0 +1,320 @@
+/*********************************************************************************
+created:	2026/10/21   05:10PM
+filename: 	fvkMultiFaceTracker.cpp
+file base:	fvkMultiFaceTracker
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that tracks several faces at once. Every face has its own region
+of interest, template and lost timer, the same as the single face of fvkFaceDetector.
+The full frame is only searched on a schedule or when a face is lost, and the
+tracking of the faces is capped by a time budget per frame.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkMultiFaceTracker.h>
+#include <fvk/camera/fvkFaceDetector.h>
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+
+using namespace R3D;
+
+// milliseconds since _t (a cv::getTickCount value).
+static auto __elapsed(int64 _t) -> double
+{
+	return static_cast<double>(cv::getTickCount() - _t) * 1000.0 / cv::getTickFrequency();
+}
+
+// rectangle with the double size around the same center, clipped to the frame.
+static auto __doubleRect(const cv::Rect& _rect, const cv::Size& _frame) -> cv::Rect
+{
+	const cv::Rect r(_rect.x - _rect.width / 2, _rect.y - _rect.height / 2, _rect.width * 2, _rect.height * 2);
+	return r & cv::Rect(cv::Point(0, 0), _frame);
+}
+
+// intersection over union of two rectangles.
+static auto __overlap(const cv::Rect& _a, const cv::Rect& _b) -> double
+{
+	const auto i = (_a & _b).area();
+	const auto u = _a.area() + _b.area() - i;
+	return u > 0 ? static_cast<double>(i) / static_cast<double>(u) : 0.0;
+}
+
+fvkMultiFaceTracker::fvkMultiFaceTracker() :
+m_scale(1),
+m_width(320),
+m_maxfaces(8),
+m_interval(30),
+m_budget(10),
+m_lostduration(3),
+m_frames(-1),
+m_next(0),
+m_nextid(1)
+{
+}
+
+auto fvkMultiFaceTracker::loadCascadeClassifier(const std::string& _filename) -> bool
+{
+	auto b = fvkFaceDetectorBackend::createFromCascade(_filename);
+	if (!b)
+		return false;
+
+	m_backend = std::move(b);
+	reset();
+	return true;
+}
+
+auto fvkMultiFaceTracker::loadFaceDetector(fvkFaceDetectorBackend::Type _type, const std::string& _filename) -> bool
+{
+	auto b = fvkFaceDetectorBackend::create(_type);
+	if (_filename.empty() || !b->load(_filename) || b->empty())
+		return false;
+
+	m_backend = std::move(b);
+	reset();
+	return true;
+}
+
+auto fvkMultiFaceTracker::isLoaded() const -> bool
+{
+	return m_backend && !m_backend->empty();
+}
+
+void fvkMultiFaceTracker::setResizedWidth(int _width)
+{
+	m_width = std::max(_width, 1);
+}
+auto fvkMultiFaceTracker::getResizedWidth() const -> int
+{
+	return m_width;
+}
+
+void fvkMultiFaceTracker::setMaxFaces(int _value)
+{
+	m_maxfaces = std::max(_value, 1);
+}
+auto fvkMultiFaceTracker::getMaxFaces() const -> int
+{
+	return m_maxfaces;
+}
+
+void fvkMultiFaceTracker::setDetectionInterval(int _frames)
+{
+	m_interval = std::max(_frames, 1);
+}
+auto fvkMultiFaceTracker::getDetectionInterval() const -> int
+{
+	return m_interval;
+}
+
+void fvkMultiFaceTracker::setTrackingBudget(double _msec)
+{
+	m_budget = _msec;
+}
+auto fvkMultiFaceTracker::getTrackingBudget() const -> double
+{
+	return m_budget;
+}
+
+void fvkMultiFaceTracker::setLostDuration(double _s)
+{
+	m_lostduration = _s;
+}
+auto fvkMultiFaceTracker::getLostDuration() const -> double
+{
+	return m_lostduration;
+}
+
+auto fvkMultiFaceTracker::getFaces() const -> std::vector<fvkTrackedFace>
+{
+	return m_faces;
+}
+
+void fvkMultiFaceTracker::reset()
+{
+	m_tracks.clear();
+	m_faces.clear();
+	m_frames = -1;
+	m_next = 0;
+}
+
+void fvkMultiFaceTracker::update(const cv::Mat& _gray, Track& _track, const cv::Rect& _rect)
+{
+	_track.rect = _rect & cv::Rect(cv::Point(0, 0), _gray.size());
+
+	// the template is a small patch in the middle of the face.
+	const cv::Rect t(_track.rect.x + _track.rect.width / 4, _track.rect.y + _track.rect.height / 4, _track.rect.width / 2, _track.rect.height / 2);
+	if (t.area() > 0)
+		_track.templ = _gray(t).clone();
+	_track.roi = __doubleRect(_track.rect, _gray.size());
+}
+
+void fvkMultiFaceTracker::detectAll(const cv::Mat& _gray)
+{
+	// faces from 1/10th to 2/3rds of the frame height.
+	m_backend->detect(_gray, m_detected,
+		cv::Size(_gray.rows / 10, _gray.rows / 10),
+		cv::Size(_gray.rows * 2 / 3, _gray.rows * 2 / 3));
+
+	for (const auto& d : m_detected)
+	{
+		// the detection refreshes the track it overlaps most, or becomes a new track.
+		Track* best = nullptr;
+		auto bestoverlap = 0.3;
+		for (auto& t : m_tracks)
+		{
+			const auto o = __overlap(t.rect, d);
+			if (!t.updated && o > bestoverlap)
+			{
+				best = &t;
+				bestoverlap = o;
+			}
+		}
+
+		if (!best)
+		{
+			if (static_cast<int>(m_tracks.size()) >= m_maxfaces)
+				continue;
+			m_tracks.push_back(Track { m_nextid++, d, cv::Rect(), cv::Mat(), 0, false });
+			best = &m_tracks.back();
+		}
+
+		update(_gray, *best, d);
+		best->lost_since = 0;
+		best->updated = true;
+	}
+}
+
+void fvkMultiFaceTracker::track(const cv::Mat& _gray, Track& _track)
+{
+	if (_track.roi.area() <= 0)
+		return;
+
+	// faces sized +/-20% off the face in the region around it.
+	const auto w = _track.rect.width;
+	const auto h = _track.rect.height;
+	m_backend->detect(_gray(_track.roi), m_detected,
+		cv::Size(w * 8 / 10, h * 8 / 10),
+		cv::Size(w * 12 / 10, h * 12 / 10));
+
+	if (!m_detected.empty())
+	{
+		// the face closest to the previous position, so the tracks do not swap faces.
+		const auto c = cv::Point(_track.rect.x + _track.rect.width / 2, _track.rect.y + _track.rect.height / 2) - _track.roi.tl();
+		auto best = m_detected.front();
+		auto bestdist = -1.0;
+		for (const auto& d : m_detected)
+		{
+			const auto dc = cv::Point(d.x + d.width / 2, d.y + d.height / 2) - c;
+			const auto dist = static_cast<double>(dc.dot(dc));
+			if (bestdist < 0 || dist < bestdist)
+			{
+				best = d;
+				bestdist = dist;
+			}
+		}
+		update(_gray, _track, best + _track.roi.tl());
+		_track.lost_since = 0;
+		return;
+	}
+
+	// the detector lost the face, so it is followed by template matching until it is dropped.
+	if (_track.lost_since == 0)
+		_track.lost_since = cv::getTickCount();
+
+	const auto roi = _gray(_track.roi);
+	if (_track.templ.empty() || roi.cols < _track.templ.cols || roi.rows < _track.templ.rows)
+		return;
+
+	cv::matchTemplate(roi, _track.templ, m_matching, cv::TM_SQDIFF_NORMED);
+	cv::Point loc;
+	cv::minMaxLoc(m_matching, nullptr, nullptr, &loc);
+	const cv::Rect t(loc + _track.roi.tl(), _track.templ.size());
+	update(_gray, _track, __doubleRect(t, _gray.size()));
+}
+
+auto fvkMultiFaceTracker::detect(const cv::Mat& _frame) -> std::vector<fvkTrackedFace>
+{
+	fvkFramePyramid pyramid(_frame);
+	return detect(pyramid);
+}
+
+auto fvkMultiFaceTracker::detect(fvkFramePyramid& _pyramid) -> std::vector<fvkTrackedFace>
+{
+	if (!isLoaded() || _pyramid.empty())
+		return m_faces;
+
+	cv::Mat small;
+	const auto scale = fvkFaceDetector::downscale(_pyramid, small, m_width);
+	if (scale <= 0)
+		return m_faces;
+	m_scale = scale;
+
+	const auto gray = _pyramid.gray(m_width);
+
+	for (auto& t : m_tracks)
+		t.updated = false;
+
+	// the full frame is searched with the first frame and then on the schedule, which is
+	// four times faster while a face is lost or there is no face at all.
+	const auto lost = std::any_of(m_tracks.begin(), m_tracks.end(), [](const Track& _t) { return _t.lost_since != 0; });
+	const auto interval = (lost || m_tracks.empty()) ? std::max(1, m_interval / 4) : m_interval;
+	if (m_frames < 0 || ++m_frames >= interval)
+	{
+		detectAll(gray);
+		m_frames = 0;
+	}
+
+	// the other faces are tracked in turn within the budget.
+	const auto start = cv::getTickCount();
+	const auto n = m_tracks.size();
+	std::size_t done = 0;
+	std::size_t i = 0;
+	for (; i < n; i++)
+	{
+		auto& t = m_tracks[(m_next + i) % n];
+		if (t.updated)
+			continue;
+		if (done > 0 && __elapsed(start) > m_budget)
+			break;
+		track(gray, t);
+		done++;
+	}
+	m_next = n > 0 ? (m_next + i) % n : 0;
+
+	// drop the faces that are lost for too long and the tracks that followed the same face.
+	const auto now = cv::getTickCount();
+	const auto lostticks = static_cast<int64>(m_lostduration * cv::getTickFrequency());
+	for (std::size_t a = 0; a < m_tracks.size(); a++)
+	{
+		auto drop = m_tracks[a].lost_since != 0 && now - m_tracks[a].lost_since > lostticks;
+		for (std::size_t b = 0; b < a && !drop; b++)
+			drop = __overlap(m_tracks[a].rect, m_tracks[b].rect) > 0.5;
+		if (drop)
+			m_tracks.erase(m_tracks.begin() + static_cast<std::ptrdiff_t>(a--));
+	}
+	if (m_next >= m_tracks.size())
+		m_next = 0;
+
+	m_faces.clear();
+	for (const auto& t : m_tracks)
+	{
+		fvkTrackedFace f;
+		f.id = t.id;
+		f.rect = cv::Rect(static_cast<int>(t.rect.x / m_scale), static_cast<int>(t.rect.y / m_scale),
+			static_cast<int>(t.rect.width / m_scale), static_cast<int>(t.rect.height / m_scale));
+		f.lost = t.lost_since != 0;
+		m_faces.push_back(f);
+	}
+	return m_faces;
+}
@@ -0,0 +1,277 @@
+/*********************************************************************************
+created:	2026/10/21   10:15AM
+filename: 	fvkOfflineProcessor.cpp
+file base:	fvkOfflineProcessor
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that processes a video file as fast as the hardware allows,
+e.g. to reprocess archived footage with the settings of a camera.
+One thread decodes ahead, the frames are filtered concurrently by a processing
+pool and the encoder receives them in their original order.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkOfflineProcessor.h>
+#include <fvk/camera/fvkProcessingPool.h>
+#include <fvk/camera/fvkVideoWriter.h>
+
+#include <condition_variable>
+#include <deque>
+#include <thread>
+#include <algorithm>
+
+using namespace R3D;
+
+using Stage = fvkImageProcessing::Stage;
+
+// milliseconds since _t (a cv::getTickCount value).
+static auto elapsed(int64 _t) -> double
+{
+	return static_cast<double>(cv::getTickCount() - _t) * 1000.0 / cv::getTickFrequency();
+}
+
+fvkOfflineProcessor::fvkOfflineProcessor() :
+m_workers(0),
+m_readahead(16),
+m_progress(nullptr),
+m_cancel(false)
+{
+}
+
+void fvkOfflineProcessor::setWorkers(int _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_workers = std::max(0, _value);
+}
+auto fvkOfflineProcessor::getWorkers() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_workers;
+}
+
+void fvkOfflineProcessor::setReadAhead(int _frames)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_readahead = std::max(1, _frames);
+}
+auto fvkOfflineProcessor::getReadAhead() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_readahead;
+}
+
+void fvkOfflineProcessor::setCodec(const std::string& _codec)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_codec = _codec;
+}
+auto fvkOfflineProcessor::getCodec() const -> std::string
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_codec;
+}
+
+void fvkOfflineProcessor::setProgressFunction(std::function<void(long long, long long)> _func)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_progress = std::move(_func);
+}
+
+void fvkOfflineProcessor::cancel()
+{
+	m_cancel = true;
+}
+
+auto fvkOfflineProcessor::getStats() const -> fvkOfflineStats
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_stats;
+}
+
+auto fvkOfflineProcessor::process(const std::string& _input, const std::string& _output, fvkImageProcessing& _settings) -> bool
+{
+	int nworkers, readahead;
+	std::string codec;
+	std::function<void(long long, long long)> progress;
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		nworkers = m_workers > 0 ? m_workers : std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		readahead = m_readahead;
+		codec = m_codec;
+		progress = m_progress;
+		m_stats = fvkOfflineStats();
+	}
+	m_cancel = false;
+
+	cv::VideoCapture cap(_input);
+	if (!cap.isOpened())
+		return false;
+
+	const auto total = static_cast<long long>(cap.get(cv::CAP_PROP_FRAME_COUNT));
+	auto fps = cap.get(cv::CAP_PROP_FPS);
+	if (fps <= 0)
+		fps = 25;
+	if (codec.empty())
+	{
+		const auto fourcc = static_cast<int>(cap.get(cv::CAP_PROP_FOURCC));
+		for (auto i = 0; i < 4; i++)
+			codec.push_back(static_cast<char>((fourcc >> (8 * i)) & 0xff));
+	}
+
+	// the processing object of this file, so the settings can not change in the middle of it.
+	// The face detection is done in order on every frame, because the file is not real time.
+	fvkImageProcessing ip;
+	ip.copySettings(_settings);
+	ip.setAsyncFaceDetectionEnabled(false);
+	auto& fd = _settings.getSimpleFaceDetector();
+	if (ip.isFaceDetectionEnabled() && !ip.loadFaceDetector(fd.getBackendType(), fd.getCascadeClassifierFilePath()))
+		ip.setFaceDetectionEnabled(false);
+
+	std::mutex mutex;
+	std::vector<double> stages(static_cast<std::size_t>(Stage::Output), 0.0);
+	auto decode = 0.0;
+	long long written = 0;
+	auto failed = false;
+
+	// decoding thread: it keeps up to readahead frames ready for the processing.
+	std::deque<cv::Mat> frames;
+	auto eof = false;
+	std::condition_variable framecond, spacecond;
+	std::thread decoder([&]()
+	{
+		while (!m_cancel)
+		{
+			{
+				std::unique_lock<std::mutex> lk(mutex);
+				spacecond.wait(lk, [&]() { return m_cancel || frames.size() < static_cast<std::size_t>(readahead); });
+			}
+			if (m_cancel)
+				break;
+
+			cv::Mat frame;
+			const auto t = cv::getTickCount();
+			const auto ok = cap.read(frame) && !frame.empty();
+			{
+				std::lock_guard<std::mutex> lk(mutex);
+				if (!ok)
+					break;
+				decode += elapsed(t);
+				frames.push_back(frame);
+			}
+			framecond.notify_one();
+		}
+		{
+			std::lock_guard<std::mutex> lk(mutex);
+			eof = true;
+		}
+		framecond.notify_one();
+	});
+
+	// encoding: the pool gives the frames in their original order from its output thread.
+	// The writer is opened with the first processed frame, because the geometric
+	// transform and the color conversion can change its size and type.
+	fvkVideoWriter writer;
+	writer.setOutputLocation(_output);
+	writer.setFps(fps);
+	if (codec.length() == 4 && codec[0] != 0)
+		writer.setCodec(codec);
+
+	const auto start = cv::getTickCount();
+
+	fvkProcessingPool pool;
+	pool.start(nworkers, &ip, [&](cv::Mat& _frame)
+	{
+		if (failed)
+			return;
+
+		// addFrame only queues the frame, the encoding time is taken from the writer.
+		if (!_output.empty())
+		{
+			if (!writer.isOpened())
+			{
+				writer.setSize(_frame.size());
+				writer.setColored(_frame.channels() > 1);
+				if (writer.open() != 1)
+				{
+					failed = true;
+					m_cancel = true;
+					{ std::lock_guard<std::mutex> lk(mutex); }
+					spacecond.notify_one();
+					return;
+				}
+			}
+			writer.addFrame(_frame);
+		}
+
+		long long n;
+		{
+			std::lock_guard<std::mutex> lk(mutex);
+			n = ++written;
+		}
+		if (progress)
+			progress(n, total);
+	}, [&](const std::vector<double>& _times)
+	{
+		std::lock_guard<std::mutex> lk(mutex);
+		for (auto i = 0; i < static_cast<int>(Stage::Output); i++)
+			stages[i] += _times[i];
+	});
+
+	// geometry and face tracking depend on the previous frames, so they are done by this
+	// thread in the order of the file.
+	while (!m_cancel)
+	{
+		cv::Mat frame;
+		{
+			std::unique_lock<std::mutex> lk(mutex);
+			framecond.wait(lk, [&]() { return eof || !frames.empty(); });
+			if (frames.empty())
+				break;
+			frame = frames.front();
+			frames.pop_front();
+		}
+		spacecond.notify_one();
+
+		const auto face = ip.preProcessing(frame);
+		pool.submit(frame, face, ip.getTrackedFaces(), ip.getStageTimes());
+	}
+
+	// the lock makes sure that the decoder has seen the cancellation or is waiting.
+	{ std::lock_guard<std::mutex> lk(mutex); }
+	spacecond.notify_one();
+	decoder.join();
+
+	// wait for the frames in the pool to be written.
+	pool.stop();
+	writer.stop();
+
+	fvkOfflineStats stats;
+	stats.frames = written;
+	stats.failed = pool.getFailedCount();
+	stats.workers = nworkers;
+	stats.seconds = elapsed(start) / 1000.0;
+	stats.fps = stats.seconds > 0 ? static_cast<double>(written) / stats.seconds : 0;
+	stats.stages = stages;
+	if (written > 0)
+	{
+		stats.decode = decode / written;
+		stats.encode = writer.getStats().encode_time;
+		stats.blocked = writer.getStats().blocked_time / written;
+		for (auto& s : stats.stages)
+			s /= written;
+	}
+
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_stats = stats;
+	return !failed;
+}
@@ -0,0 +1,432 @@
+/*********************************************************************************
+created:	2026/10/23   05:20PM
+filename: 	fvkPreEventRecorder.cpp
+file base:	fvkPreEventRecorder
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that keeps the last seconds of a camera in memory as JPEG
+images, within a memory budget, and writes them to a video file when an event
+is triggered, followed by the live frames of the post-roll. The compression is
+done by a thread of the recorder and the writing by another one, so addFrame never
+waits and the frames that come during the writing of an event are kept.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkPreEventRecorder.h>
+#include <fvk/camera/fvkClockTime.h>
+
+#include <opencv2/imgcodecs.hpp>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+using namespace R3D;
+
+static const std::size_t MAX_PENDING = 8;	// frames waiting for the thread before the new ones are dropped.
+static const int MAX_RAW = 8;				// raw frames waiting to be written, the others are given compressed.
+
+// bytes of the pixels or of the compressed data of a frame.
+static auto __bytes(const cv::Mat& _image, const std::shared_ptr<const std::vector<uchar>>& _data) -> std::size_t
+{
+	return !_image.empty() ? _image.total() * _image.elemSize() : (_data ? _data->size() : 0);
+}
+
+fvkPreEventRecorder::fvkPreEventRecorder() :
+m_active(false),
+m_stop(false),
+m_writestop(false),
+m_itembytes(0),
+m_itemraw(0),
+m_until(0),
+m_recording(false),
+m_preroll(5),
+m_postroll(10),
+m_budget(64 * 1024 * 1024),
+m_quality(90),
+m_ext(".avi")
+{
+}
+
+fvkPreEventRecorder::~fvkPreEventRecorder()
+{
+	stop();
+}
+
+void fvkPreEventRecorder::start()
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	if (m_active)
+		return;
+
+	m_active = true;
+	m_stop = false;
+	m_writestop = false;
+	m_thread = std::thread([this]() { run(); });
+	m_writethread = std::thread([this]() { write(); });
+}
+
+void fvkPreEventRecorder::stop()
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		if (!m_active)
+			return;
+		m_active = false;
+		m_stop = true;
+	}
+	m_cond.notify_all();
+	if (m_thread.joinable())
+		m_thread.join();
+
+	// the writing thread writes the frames it was given and closes the event file.
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_writestop = true;
+	}
+	m_writecond.notify_all();
+	if (m_writethread.joinable())
+		m_writethread.join();
+
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_pending.clear();
+	m_triggers.clear();
+	m_stats.buffered = 0;
+	m_stats.memory = 0;
+	m_stats.seconds = 0;
+	m_stats.recording = false;
+	m_stats.writing = 0;
+}
+
+auto fvkPreEventRecorder::isActive() const -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_active;
+}
+
+void fvkPreEventRecorder::addFrame(const cv::Mat& _frame)
+{
+	if (_frame.empty())
+		return;
+
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		if (!m_active)
+			return;
+
+		m_stats.frames++;
+		if (m_pending.size() >= MAX_PENDING)
+		{
+			m_stats.dropped++;
+			return;
+		}
+		m_pending.push_back(Frame { _frame, cv::getTickCount() });
+	}
+	m_cond.notify_one();
+}
+
+auto fvkPreEventRecorder::trigger(const std::string& _filename) -> bool
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		if (!m_active)
+			return false;
+
+		auto file = _filename;
+		if (file.empty())
+		{
+			file = "event_" + fvkClockTime::getLocalTime("%Y%m%d_%H%M%S") + m_ext;
+			if (!m_folder.empty())
+				file = m_folder + "/" + file;
+		}
+		m_triggers.push_back(file);
+	}
+	m_cond.notify_one();
+	return true;
+}
+
+auto fvkPreEventRecorder::open(const std::string& _filename, const cv::Mat& _frame) -> bool
+{
+	m_writer.setOutputLocation(_filename);
+	m_writer.setSize(_frame.size());
+	m_writer.setColored(_frame.channels() > 1);
+	if (m_writer.open() != 1)
+	{
+		std::cout << "could not open the event file " << _filename << "\n";
+		return false;
+	}
+	return true;
+}
+
+void fvkPreEventRecorder::close()
+{
+	// the writer encodes its queued frames before it closes the file.
+	if (m_writer.isOpened())
+	{
+		m_writer.stop();
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_stats.events++;
+	}
+}
+
+void fvkPreEventRecorder::post(Item _item, bool _live, std::size_t _budget)
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+
+		// a live frame is kept raw while the writing thread keeps up, and compressed
+		// otherwise; it is only dropped if the compressed frames exceed the memory budget.
+		if (_live && !_item.image.empty() && m_itemraw >= MAX_RAW)
+			_item.image.release();
+		if (_live && _item.image.empty() && (!_item.data || m_itembytes + _item.data->size() > _budget))
+		{
+			m_stats.dropped++;
+			return;
+		}
+
+		m_itembytes += __bytes(_item.image, _item.data);
+		if (!_item.image.empty())
+			m_itemraw++;
+		m_items.push_back(std::move(_item));
+		m_stats.writing = static_cast<int>(m_items.size());
+	}
+	m_writecond.notify_one();
+}
+
+void fvkPreEventRecorder::write()
+{
+	std::string file;
+	while (true)
+	{
+		Item item;
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			m_writecond.wait(lk, [this]() { return !m_items.empty() || m_writestop; });
+			if (m_items.empty())
+				break;
+			item = std::move(m_items.front());
+			m_items.pop_front();
+			m_itembytes -= __bytes(item.image, item.data);
+			if (!item.image.empty())
+				m_itemraw--;
+			m_stats.writing = static_cast<int>(m_items.size());
+		}
+
+		if (!item.file.empty())
+		{
+			file = item.file;
+			continue;
+		}
+		if (item.close)
+		{
+			close();
+			file.clear();
+			continue;
+		}
+
+		const auto image = !item.image.empty() ? item.image : (item.data ? cv::imdecode(*item.data, cv::IMREAD_UNCHANGED) : cv::Mat());
+		if (image.empty() || file.empty())
+			continue;
+
+		// the file is opened with the size of its first frame; the event is skipped if it fails.
+		if (!m_writer.isOpened() && !open(file, image))
+		{
+			file.clear();
+			continue;
+		}
+		m_writer.addFrame(image);
+	}
+
+	close();
+}
+
+void fvkPreEventRecorder::run()
+{
+	std::deque<Frame> frames;
+	std::vector<std::string> triggers;
+	std::size_t memory = 0;
+	auto totalcompress = 0.0;
+	long long ncompressed = 0;
+
+	while (true)
+	{
+		int quality;
+		double preroll, postroll;
+		std::size_t budget;
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			const auto ready = [this]() { return !m_pending.empty() || !m_triggers.empty() || m_stop; };
+			if (m_recording)
+			{
+				// the post-roll ends even if no frame comes.
+				const auto wait = static_cast<double>(m_until - cv::getTickCount()) / cv::getTickFrequency();
+				if (wait > 0)
+					m_cond.wait_for(lk, std::chrono::duration<double>(wait), ready);
+			}
+			else
+			{
+				m_cond.wait(lk, ready);
+			}
+			if (m_stop)
+				break;
+
+			frames.swap(m_pending);
+			triggers.swap(m_triggers);
+			quality = m_quality;
+			preroll = m_preroll;
+			postroll = m_postroll;
+			budget = m_budget;
+		}
+
+		// this thread only compresses the frames and gives them to the writing thread,
+		// so it keeps up with the camera while an event file is written.
+		const std::vector<int> params = { cv::IMWRITE_JPEG_QUALITY, quality };
+		for (const auto& f : frames)
+		{
+			if (m_recording && f.tick > m_until)
+			{
+				post(Item { std::string(), cv::Mat(), nullptr, true }, false, budget);
+				m_recording = false;
+			}
+
+			// the pre-roll is kept while recording, so the next event has its own.
+			std::shared_ptr<std::vector<uchar>> data(new std::vector<uchar>());
+			const auto t = cv::getTickCount();
+			if (!cv::imencode(".jpg", f.image, *data, params))
+				data.reset();
+
+			if (m_recording)
+				post(Item { std::string(), f.image, data, false }, true, budget);
+
+			if (!data)
+				continue;
+			totalcompress += static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency();
+			ncompressed++;
+			memory += data->size();
+			m_ring.push_back(Packet { data, f.tick });
+
+			// the oldest frames are released when the pre-roll is too long or too big.
+			const auto maxticks = static_cast<int64>(preroll * cv::getTickFrequency());
+			while (m_ring.size() > 1 && (m_ring.back().tick - m_ring.front().tick > maxticks || memory > budget))
+			{
+				memory -= m_ring.front().data->size();
+				m_ring.pop_front();
+			}
+		}
+		frames.clear();
+
+		for (const auto& name : triggers)
+		{
+			if (!m_recording)
+			{
+				// the pre-roll is given compressed (it is within the budget), then the live frames.
+				post(Item { name, cv::Mat(), nullptr, false }, false, budget);
+				for (const auto& p : m_ring)
+					post(Item { std::string(), cv::Mat(), p.data, false }, false, budget);
+				m_recording = true;
+			}
+			m_until = cv::getTickCount() + static_cast<int64>(postroll * cv::getTickFrequency());
+		}
+		triggers.clear();
+
+		if (m_recording && cv::getTickCount() > m_until)
+		{
+			post(Item { std::string(), cv::Mat(), nullptr, true }, false, budget);
+			m_recording = false;
+		}
+
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_stats.buffered = static_cast<int>(m_ring.size());
+		m_stats.memory = memory;
+		m_stats.seconds = m_ring.size() > 1 ? static_cast<double>(m_ring.back().tick - m_ring.front().tick) / cv::getTickFrequency() : 0;
+		m_stats.recording = m_recording;
+		m_stats.compress_time = ncompressed > 0 ? totalcompress / static_cast<double>(ncompressed) : 0;
+	}
+
+	// stopped: the event file is closed after the frames given so far.
+	if (m_recording)
+		post(Item { std::string(), cv::Mat(), nullptr, true }, false, 0);
+	m_recording = false;
+	m_ring.clear();
+}
+
+void fvkPreEventRecorder::setPreRoll(double _seconds)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_preroll = std::max(_seconds, 0.0);
+}
+auto fvkPreEventRecorder::getPreRoll() const -> double
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_preroll;
+}
+
+void fvkPreEventRecorder::setPostRoll(double _seconds)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_postroll = std::max(_seconds, 0.0);
+}
+auto fvkPreEventRecorder::getPostRoll() const -> double
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_postroll;
+}
+
+void fvkPreEventRecorder::setMemoryBudget(std::size_t _bytes)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_budget = _bytes;
+}
+auto fvkPreEventRecorder::getMemoryBudget() const -> std::size_t
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_budget;
+}
+
+void fvkPreEventRecorder::setQuality(int _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_quality = std::min(std::max(_value, 1), 100);
+}
+auto fvkPreEventRecorder::getQuality() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_quality;
+}
+
+void fvkPreEventRecorder::setOutputFolder(const std::string& _folder)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_folder = _folder;
+}
+auto fvkPreEventRecorder::getOutputFolder() const -> std::string
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_folder;
+}
+
+void fvkPreEventRecorder::setFileExtension(const std::string& _ext)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_ext = _ext;
+}
+auto fvkPreEventRecorder::getFileExtension() const -> std::string
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_ext;
+}
+
+auto fvkPreEventRecorder::getStats() const -> fvkPreEventStats
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_stats;
+}
@@ -0,0 +1,265 @@
+/*********************************************************************************
+created:	2026/10/20   09:15AM
+filename: 	fvkProcessingPool.cpp
+file base:	fvkProcessingPool
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that filters consecutive frames concurrently on several worker
+threads and gives them back in their original order.
+Every worker has its own fvkImageProcessing whose settings follow the settings
+of the processing thread.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkProcessingPool.h>
+
+#include <iostream>
+
+using namespace R3D;
+
+fvkProcessingPool::fvkProcessingPool() :
+	p_settings(nullptr),
+	m_output(nullptr),
+	m_processed(nullptr),
+	m_submitted(0),
+	m_emitted(0),
+	m_failed(0),
+	m_stop(false),
+	m_active(false)
+{
+}
+
+fvkProcessingPool::~fvkProcessingPool()
+{
+	stop();
+}
+
+void fvkProcessingPool::start(int _workers, fvkImageProcessing* _settings, std::function<void(cv::Mat&)> _output, std::function<void(const std::vector<double>&)> _processed)
+{
+	stop();
+
+	if (_workers < 1 || !_settings)
+		return;
+
+	p_settings = _settings;
+	m_output = std::move(_output);
+	m_processed = std::move(_processed);
+	m_submitted = 0;
+	m_emitted = 0;
+	m_failed = 0;
+	m_stop = false;
+	m_active = true;
+
+	m_ips.clear();
+	for (auto i = 0; i < _workers; i++)
+		m_ips.push_back(std::unique_ptr<fvkImageProcessing>(new fvkImageProcessing()));
+
+	for (auto i = 0; i < _workers; i++)
+		m_workers.push_back(std::thread([this, i]() { work(i); }));
+	m_output_thread = std::thread([this]() { output(); });
+}
+
+void fvkProcessingPool::stop()
+{
+	{
+		std::lock_guard<std::mutex> lk(m_mutex);
+		if (!m_active)
+			return;
+		m_stop = true;
+	}
+	m_jobcond.notify_all();
+	m_donecond.notify_all();
+	m_spacecond.notify_all();
+
+	// the workers finish the queued frames and the output thread emits them before exiting.
+	for (auto& t : m_workers)
+		t.join();
+	m_workers.clear();
+	if (m_output_thread.joinable())
+		m_output_thread.join();
+
+	std::lock_guard<std::mutex> lk(m_mutex);
+	m_jobs.clear();
+	m_done.clear();
+	m_last.release();
+	m_ips.clear();
+	m_active = false;
+}
+
+auto fvkProcessingPool::active() const -> bool
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	return m_active;
+}
+
+auto fvkProcessingPool::getWorkerCount() const -> int
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	return static_cast<int>(m_workers.size());
+}
+
+auto fvkProcessingPool::getFailedCount() const -> long long
+{
+	std::lock_guard<std::mutex> lk(m_mutex);
+	return m_failed;
+}
+
+void fvkProcessingPool::submit(const cv::Mat& _frame, const cv::Rect& _face, const std::vector<fvkTrackedFace>& _faces, const std::vector<double>& _times)
+{
+	std::unique_lock<std::mutex> lk(m_mutex);
+	if (!m_active || m_stop)
+		return;
+
+	const auto limit = static_cast<unsigned long long>(2 * m_workers.size());
+	m_spacecond.wait(lk, [&]() { return m_stop || m_submitted - m_emitted < limit; });
+	if (m_stop)
+		return;
+
+	m_jobs.push_back(Job { m_submitted++, _frame, _face, false, _faces, _times });
+	lk.unlock();
+	m_jobcond.notify_one();
+}
+
+void fvkProcessingPool::repeat()
+{
+	std::unique_lock<std::mutex> lk(m_mutex);
+	if (!m_active || m_stop)
+		return;
+
+	const auto limit = static_cast<unsigned long long>(2 * m_workers.size());
+	m_spacecond.wait(lk, [&]() { return m_stop || m_submitted - m_emitted < limit; });
+	if (m_stop)
+		return;
+
+	// there is nothing to process, so it goes straight to the output thread.
+	const auto seq = m_submitted++;
+	m_done[seq] = Job { seq, cv::Mat(), cv::Rect(), true };
+	lk.unlock();
+	m_donecond.notify_one();
+}
+
+void fvkProcessingPool::work(int _index)
+{
+	auto& ip = *m_ips[_index];
+	auto revision = ~0u;
+
+	while (true)
+	{
+		Job job;
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			m_jobcond.wait(lk, [&]() { return m_stop || !m_jobs.empty(); });
+			if (m_jobs.empty())
+				return;		// stopped and nothing left to do.
+			job = std::move(m_jobs.front());
+			m_jobs.pop_front();
+		}
+
+		// follow the settings of the processing thread.
+		const auto r = p_settings->getSettingsRevision();
+		if (r != revision)
+		{
+			ip.copySettings(*p_settings);
+			revision = r;
+		}
+
+		// an exception must not stall the frames that come after this one, nor end the
+		// worker, so it is reported and the frame is passed on as it was submitted.
+		// The stages filter in place, so they are given a copy of the frame.
+		auto frame = job.frame.clone();
+		auto failed = false;
+		try
+		{
+			ip.filterProcessing(frame);
+			ip.postProcessing(frame, job.face, job.faces);
+			job.frame = frame;
+		}
+		catch (const std::exception& e)
+		{
+			std::cout << "could not process frame " << job.seq << ": " << e.what() << "\n";
+			failed = true;
+		}
+		catch (...)
+		{
+			std::cout << "could not process frame " << job.seq << "\n";
+			failed = true;
+		}
+		if (failed)
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			m_failed++;
+			job.times.clear();
+		}
+
+		// the pre-processing stages were timed by the thread that submitted this frame.
+		if (m_processed && !failed)
+		{
+			auto times = ip.getStageTimes();
+			for (std::size_t i = 0; i < job.times.size() && i < static_cast<std::size_t>(fvkImageProcessing::Stage::Denoising); i++)
+				times[i] = job.times[i];
+			job.times.swap(times);
+		}
+
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			m_done[job.seq] = std::move(job);
+		}
+		m_donecond.notify_one();
+	}
+}
+
+void fvkProcessingPool::output()
+{
+	while (true)
+	{
+		cv::Mat frame;
+		std::vector<double> times;
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			m_donecond.wait(lk, [&]()
+			{
+				return m_done.count(m_emitted) > 0 || (m_stop && m_emitted == m_submitted);
+			});
+			const auto it = m_done.find(m_emitted);
+			if (it == m_done.end())
+				return;		// stopped and every submitted frame has been emitted.
+			if (it->second.repeat)
+			{
+				if (!m_last.empty())
+					frame = m_last.clone();
+			}
+			else
+			{
+				frame = it->second.frame;
+				times.swap(it->second.times);
+			}
+			m_done.erase(it);
+		}
+
+		// one thread in the order of the frames, e.g. for the quality governor.
+		if (m_processed && !times.empty())
+			m_processed(times);
+
+		if (m_output && !frame.empty())
+		{
+			m_last = frame;
+			m_output(frame);
+		}
+
+		{
+			std::lock_guard<std::mutex> lk(m_mutex);
+			m_emitted++;
+		}
+		m_spacecond.notify_one();
+	}
+}
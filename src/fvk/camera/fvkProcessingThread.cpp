@@ -31,7 +31,9 @@ fvkProcessingThread::fvkProcessingThread(const int _device_index, fvkCameraAbstr
 	p_buffer(_buffer),
 	m_filepath("D:\\saved_snapshot.jpg"),
 	m_save(false),
-	m_video_output_func(nullptr)
+	m_video_output_func(nullptr),
+	m_processing_func(nullptr),
+	m_nworkers(1)
 {
 	// this thread is synchronized with the camera thread by semaphore buffer,
 	// which means it is fully dependent on the camera thread, if a frame is
@@ -49,10 +51,12 @@ fvkProcessingThread::fvkProcessingThread(const int _device_index, fvkSemaphoreBu
 fvkProcessingThread::~fvkProcessingThread()
 {
 	if(active())
-	{
 		stop();
-		m_vr.stop();
-	}
+
+	// the frames still being filtered by the workers are emitted before the recording is closed.
+	m_pool.stop();
+	m_vr.stop();
+	m_per.stop();
 }
 
 void fvkProcessingThread::run()
@@ -63,26 +67,113 @@ void fvkProcessingThread::run()
 	// get a frame from the camera buffer.
 	auto frame = p_buffer->get();
 
-	// do some basic image processing
-	m_ip.imageProcessing(frame);
+	// a fixed pipeline replaces the configurable image processing.
+	if (m_processing_func)
+	{
+		if (m_pool.active())
+			m_pool.stop();
+		m_processing_func(frame);
+		output(frame);
+		return;
+	}
+
+	const int nworkers = m_nworkers;
+	if (nworkers > 1)
+	{
+		if (m_pool.getWorkerCount() != nworkers)
+		{
+			m_pool.start(nworkers, &m_ip, [this](cv::Mat& _frame) { output(_frame); }, [this, nworkers](const std::vector<double>& _times)
+			{
+				// on the output thread of the pool, in the order of the frames.
+				if (m_governor.update(m_ip, _times, nworkers))
+					m_ip.setQualityReduction(m_governor.getQualityReduction());
+			});
+		}
+
+		// a static frame is replaced by the previous output in its turn.
+		// The gate and the face detection share the downscaled copies of the frame.
+		m_pyramid.reset(frame);
+		if (m_gate.isStatic(m_pyramid, m_ip.getSettingsRevision()))
+		{
+			m_pool.repeat();
+			return;
+		}
+
+		// geometry and face tracking depend on the previous frames, so they are done here
+		// in the capture order, and the filters are done by the workers.
+		const auto face = m_ip.preProcessing(frame, m_pyramid);
+		m_pool.submit(frame, face, m_ip.getTrackedFaces(), m_ip.getStageTimes());
+		return;
+	}
+
+	if (m_pool.active())
+	{
+		m_pool.stop();
+		m_last.release();
+	}
 
+	// a static frame is not processed again, the last processed frame is used instead.
+	// The gate and the face detection share the downscaled copies of the frame.
+	if (m_last.empty())
+		m_gate.reset();
+	m_pyramid.reset(frame);
+	if (m_gate.isStatic(m_pyramid, m_ip.getSettingsRevision()))
+	{
+		auto last = m_last.clone();
+		output(last);
+		return;
+	}
+
+	// do some basic image processing (the stages of imageProcessing, with the pyramid).
+	const auto face = m_ip.preProcessing(frame, m_pyramid);
+	m_ip.filterProcessing(frame);
+	m_ip.postProcessing(frame, face, m_ip.getTrackedFaces());
+
+	// keep the processing within the frame budget.
+	if (m_governor.update(m_ip, m_ip.getStageTimes()))
+		m_ip.setQualityReduction(m_governor.getQualityReduction());
+
+	output(frame);
+	m_last = m_gate.isEnabled() ? frame : cv::Mat();
+}
+
+void fvkProcessingThread::output(cv::Mat& _frame)
+{
 	// send frame to the observer to process it on another class.
 	if (p_frameobserver)
-		p_frameobserver->present(frame);
+		p_frameobserver->present(_frame);
 
 	// expected to be overridden in the derived class.
-	present(frame);
+	present(_frame);
 
 	// emit signal to inform to image box for the new frame.
 	if (m_video_output_func)
-		m_video_output_func(frame, m_avgfps.getStats());
+		m_video_output_func(_frame, m_avgfps.getStats());
 
 	// save current frame to disk.
-	saveFrameToDisk(frame);
+	saveFrameToDisk(_frame);
 
-	// add frame for the video recording.
+	// add frame for the video recording (it is encoded by the thread of the writer).
 	if (m_vr.isOpened())
-		m_vr.addFrame(frame);
+		m_vr.addFrame(_frame);
+
+	// keep the frame for the events (it is compressed by the thread of the recorder).
+	if (m_per.isActive())
+		m_per.addFrame(_frame);
+}
+
+void fvkProcessingThread::setProcessingWorkers(const int _n)
+{
+	m_nworkers = _n < 1 ? 1 : _n;
+}
+auto fvkProcessingThread::getProcessingWorkers() const -> int
+{
+	return m_nworkers;
+}
+
+void fvkProcessingThread::setProcessingFunction(const std::function<void(cv::Mat&)> _f)
+{
+	m_processing_func = std::move(_f);
 }
 
 void fvkProcessingThread::setVideoOutput(const std::function<void(cv::Mat&, const fvkThreadStats&)> _f)
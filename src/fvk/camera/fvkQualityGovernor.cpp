@@ -0,0 +1,278 @@
+/*********************************************************************************
+created:	2026/10/20   11:30AM
+filename: 	fvkQualityGovernor.cpp
+file base:	fvkQualityGovernor
+file ext:	cpp
+author:		Furqan Ullah (Post-doc, Ph.D.)
+website:    http://real3d.pk
+CopyRight:	All Rights Reserved
+
+purpose:	class that keeps the processing of a camera within its frame budget.
+It measures the cost of every image processing stage against the frame period,
+lowers the quality of the most expensive stages when the processing falls behind
+and restores them (last lowered first) when there is enough headroom again.
+
+/**********************************************************************************
+*	Fast Visualization Kit (FVK)
+*	Copyright (C) 2017 REAL3D
+*
+* This file and its content is protected by a software license.
+* You should have received a copy of this license with this file.
+* If not, please contact Dr. Furqan Ullah immediately:
+**********************************************************************************/
+
+#include <fvk/camera/fvkQualityGovernor.h>
+
+#include <algorithm>
+
+using namespace R3D;
+
+using Stage = fvkImageProcessing::Stage;
+
+static const double SMOOTHING = 0.1;	// weight of the new frame in the smoothed stage times.
+static const int PATIENCE = 10;			// frames above the high threshold before the quality is lowered.
+static const int RECOVERY = 90;			// frames below the low threshold before the quality is restored.
+static const int COOLDOWN = 30;			// frames to wait after a decision.
+
+fvkQualityGovernor::fvkQualityGovernor() :
+m_enabled(false),
+m_budget(0),
+m_low(0.6),
+m_high(0.9),
+m_over(0),
+m_under(0),
+m_cooldown(0)
+{
+}
+
+void fvkQualityGovernor::setEnabled(bool _value)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_enabled = _value;
+}
+auto fvkQualityGovernor::isEnabled() const -> bool
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_enabled;
+}
+
+void fvkQualityGovernor::setFrameBudget(double _msec)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_budget = _msec;
+	m_stats.budget = _msec;
+}
+auto fvkQualityGovernor::getFrameBudget() const -> double
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_budget;
+}
+
+void fvkQualityGovernor::setLoadThresholds(double _low, double _high)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_low = std::min(_low, _high);
+	m_high = std::max(_low, _high);
+}
+
+auto fvkQualityGovernor::getQualityReduction() const -> fvkImageProcessing::QualityReduction
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_reduction;
+}
+auto fvkQualityGovernor::getStats() const -> fvkQualityStats
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_stats;
+}
+
+auto fvkQualityGovernor::cost(Stage _first, Stage _last) const -> double
+{
+	auto c = 0.0;
+	for (auto i = static_cast<int>(_first); i <= static_cast<int>(_last); i++)
+		c += m_times[i];
+	return c;
+}
+
+auto fvkQualityGovernor::reduce(const Settings& _settings, bool _filters, bool _faces) -> bool
+{
+	auto r = m_reduction;
+
+	// candidate knobs with the time of the stages they speed up.
+	// a knob whose stages take less than a tenth of the time is not worth lowering.
+	const auto total = cost(Stage::Geometry, Stage::ConvertColor);
+	auto best = Knob::ProcessingScale;
+	auto bestcost = -1.0;
+	auto consider = [&](Knob _knob, double _cost)
+	{
+		if (_cost >= 0.1 * total && _cost > bestcost)
+		{
+			best = _knob;
+			bestcost = _cost;
+		}
+	};
+
+	if (_filters)
+	{
+		const auto npr = m_times[static_cast<int>(Stage::Smoothness)] + cost(Stage::Details, Stage::Stylization);
+		if (!r.fast_npr && _settings.npr_quality == fvkImageProcessing::FilterQuality::Exact)
+			consider(Knob::NonPhotorealistic, npr);
+
+		const auto level = r.denoise_level_max > 0 ? std::min(r.denoise_level_max, _settings.denoising_level) : _settings.denoising_level;
+		if (level > 3)
+			consider(Knob::Denoising, m_times[static_cast<int>(Stage::Denoising)]);
+	}
+	if (_faces)
+	{
+		if (_settings.face_detection && r.face_detection_interval < 40)
+			consider(Knob::FaceDetection, m_times[static_cast<int>(Stage::FaceDetection)]);
+	}
+
+	// the processing scale lowers the resolution of every filter, so it is the last resort.
+	if (bestcost < 0 && _filters && r.processing_scale > 50 && cost(Stage::Denoising, Stage::ConvertColor) > 0.5)
+	{
+		best = Knob::ProcessingScale;
+		bestcost = 0;
+	}
+	if (bestcost < 0)
+		return false;
+
+	m_steps.push_back(Step { best, r, m_stats.load, -1.0 });
+
+	switch (best)
+	{
+	case Knob::NonPhotorealistic:
+		r.fast_npr = true;
+		m_stats.decision = "non-photorealistic filters switched to the fast quality";
+		break;
+	case Knob::Denoising:
+	{
+		const auto level = r.denoise_level_max > 0 ? std::min(r.denoise_level_max, _settings.denoising_level) : _settings.denoising_level;
+		r.denoise_level_max = std::max(3, (level / 2) | 1);
+		m_stats.decision = "denoising kernel limited to " + std::to_string(r.denoise_level_max);
+		break;
+	}
+	case Knob::FaceDetection:
+		r.face_detection_interval = r.face_detection_interval > 0 ? r.face_detection_interval * 2 : 10;
+		m_stats.decision = "face detection every " + std::to_string(r.face_detection_interval) + " frames";
+		break;
+	case Knob::ProcessingScale:
+		r.processing_scale -= 25;
+		m_stats.decision = "filters processed at " + std::to_string(r.processing_scale) + "% of the frame size";
+		break;
+	}
+
+	m_reduction = r;
+	m_stats.reductions++;
+	return true;
+}
+
+auto fvkQualityGovernor::update(fvkImageProcessing& _ip, const std::vector<double>& _stage_times, int _workers) -> bool
+{
+	// the getters of _ip take its lock, so they are called before the one of the governor.
+	const Settings settings { _ip.getNonPhotorealisticQuality(), _ip.getDenoisingLevel(), _ip.isFaceDetectionEnabled() };
+
+	std::lock_guard<std::mutex> locker(m_mutex);
+
+	if (!m_enabled || m_budget <= 0)
+	{
+		if (m_steps.empty())
+			return false;
+
+		// governor turned off: remove all the reductions at once.
+		m_steps.clear();
+		m_reduction = fvkImageProcessing::QualityReduction();
+		m_stats.reduction = m_reduction;
+		m_stats.level = 0;
+		m_stats.decision = "disabled, all reductions removed";
+		return true;
+	}
+
+	if (_stage_times.size() != static_cast<std::size_t>(Stage::Output))
+		return false;
+
+	if (m_times.size() != _stage_times.size())
+		m_times = _stage_times;
+	for (std::size_t i = 0; i < m_times.size(); i++)
+		m_times[i] += SMOOTHING * (_stage_times[i] - m_times[i]);
+
+	// the geometric transform and the face detection are done by one thread, and the
+	// filters by _workers threads when the frames are processed concurrently.
+	const auto serial = cost(Stage::Geometry, Stage::FaceDetection);
+	const auto filters = cost(Stage::Denoising, Stage::ConvertColor);
+	const auto workers = std::max(1, _workers);
+	auto load = 0.0;
+	auto faces = true;
+	auto filtering = true;
+	if (workers == 1)
+	{
+		load = (serial + filters) / m_budget;
+	}
+	else
+	{
+		const auto sload = serial / m_budget;
+		const auto fload = filters / (m_budget * workers);
+		load = std::max(sload, fload);
+		faces = sload >= fload;
+		filtering = !faces;
+	}
+
+	m_stats.cost = serial + filters;
+	m_stats.load = load;
+	m_stats.stages = m_times;
+
+	if (m_cooldown > 0)
+	{
+		if (--m_cooldown == 0 && !m_steps.empty() && m_steps.back().load_after < 0)
+			m_steps.back().load_after = load;
+		return false;
+	}
+
+	if (load > m_high)
+	{
+		m_over++;
+		m_under = 0;
+	}
+	else if (load < m_low)
+	{
+		m_under++;
+		m_over = 0;
+	}
+	else
+	{
+		m_over = 0;
+		m_under = 0;
+	}
+
+	auto changed = false;
+	if (m_over >= PATIENCE)
+	{
+		m_over = 0;
+		changed = reduce(settings, filtering, faces);
+	}
+	else if (m_under >= RECOVERY && !m_steps.empty())
+	{
+		m_under = 0;
+
+		// restore the last reduction only if the load is expected to stay below the high
+		// threshold, using the load change that was measured when it was applied.
+		const auto& step = m_steps.back();
+		const auto ratio = step.load_after > 0 ? step.load_before / step.load_after : 1.0;
+		if (load * ratio < m_high)
+		{
+			m_reduction = step.previous;
+			m_steps.pop_back();
+			m_stats.restorations++;
+			m_stats.decision = "quality restored (" + std::to_string(m_steps.size()) + " reductions left)";
+			changed = true;
+		}
+	}
+
+	if (changed)
+	{
+		m_cooldown = COOLDOWN;
+		m_stats.level = static_cast<int>(m_steps.size());
+		m_stats.reduction = m_reduction;
+	}
+	return changed;
+}
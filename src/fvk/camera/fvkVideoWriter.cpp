@@ -9,6 +9,10 @@ website:    http://real3d.pk
 CopyRight:	All Rights Reserved
 
 purpose:	Thread safe class to create a video file using OpenCV video writer.
+The frames are encoded by a thread of the writer, so addFrame does not wait for
+the encoder. They are queued without a copy, and the backlog is either bounded
+(block or drop) or allowed to grow up to a memory cap. A long recording can be
+split in segments, switched by the encoder thread without losing a frame.
 
 /**********************************************************************************
 *	Fast Visualization Kit (FVK)
@@ -21,18 +25,50 @@ purpose:	Thread safe class to create a video file using OpenCV video writer.
 
 #include <fvk/camera/fvkVideoWriter.h>
 
+#include <algorithm>
+#include <fstream>
+#include <cstdio>
+#include <iostream>
+
 using namespace R3D;
 
+// bytes of the pixels of a frame.
+static auto __bytes(const cv::Mat& _frame) -> std::size_t
+{
+	return _frame.total() * _frame.elemSize();
+}
+
+// size of a file on the disk.
+static auto __fileSize(const std::string& _file) -> std::size_t
+{
+	std::ifstream in(_file, std::ios::binary | std::ios::ate);
+	const auto size = in ? static_cast<long long>(in.tellg()) : 0;
+	return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
+
+static const int SIZE_CHECK_FRAMES = 10;	// frames between two checks of the segment size.
+
 fvkVideoWriter::fvkVideoWriter() :
+	m_writer(new cv::VideoWriter()),
+	m_rotate(true),
+	m_fourcc(-1),
+	m_open(false),
+	m_stop(false),
+	m_policy(BacklogPolicy::Block),
+	m_maxbacklog(8),
+	m_maxmemory(512 * 1024 * 1024),
+	m_totalencode(0),
 	m_api(static_cast<int>(cv::VideoCaptureAPIs::CAP_FFMPEG)),
 	m_file(std::string("")),
 	m_size(cv::Size(640, 480)),
 	m_fps(25),
 	m_iscolor(true),
 	m_autocodec(false),
-	m_codec(std::string("H264"))
+	m_codec(std::string("H264")),
+	m_segmentduration(0),
+	m_segmentsize(0)
 {
-	m_writer.set(cv::VideoWriterProperties::VIDEOWRITER_PROP_QUALITY, 100.0);
+	m_writer->set(cv::VideoWriterProperties::VIDEOWRITER_PROP_QUALITY, 100.0);
 }
 fvkVideoWriter::~fvkVideoWriter()
 {
@@ -41,35 +77,158 @@ fvkVideoWriter::~fvkVideoWriter()
 
 auto fvkVideoWriter::open() -> int
 {
-	if (m_writer.isOpened())
+	std::lock_guard<std::mutex> locker(m_mutex);
+	if (m_open)
 		return -1;
 
 	if (m_autocodec)
 	{
-		m_writer.open(m_file, m_api, -1, m_fps, m_size, m_iscolor);
+		m_fourcc = -1;
 	}
 	else
 	{
 		if (m_codec.length() != 4) 
 			return -2;
 
-		m_writer.open(m_file, m_api, cv::VideoWriter::fourcc(m_codec[0], m_codec[1], m_codec[2], m_codec[3]), m_fps, m_size, m_iscolor);
+		m_fourcc = cv::VideoWriter::fourcc(m_codec[0], m_codec[1], m_codec[2], m_codec[3]);
 	}
 
-	if (!m_writer.isOpened())
+	m_segment = fvkVideoSegment();
+	m_segment.index = 1;
+	m_segment.file = isSegmented() ? segmentFile(1) : m_file;
+	m_writer = openFile(m_segment.file);
+	if (!m_writer)
 		return 0;
 
+	// the next segment is ready before the encoder needs it.
+	m_rotate = true;
+	if (isSegmented())
+	{
+		const auto file = segmentFile(2);
+		m_opener = std::thread([this, file]() { m_next = openFile(file); });
+	}
+
+	m_open = true;
+	m_stop = false;
+	m_stats = fvkVideoWriterStats();
+	m_totalencode = 0;
+	m_thread = std::thread([this]() { run(); });
+
 	return 1;
 }
 
 auto fvkVideoWriter::isOpened() const -> bool
 {
-	return m_writer.isOpened();
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_open;
 }
+
+void fvkVideoWriter::flush()
+{
+	std::unique_lock<std::mutex> lk(m_mutex);
+	m_space.wait(lk, [this]() { return m_stats.backlog == 0; });
+}
+
 void fvkVideoWriter::stop()
 {
-	if (m_writer.isOpened())
-		m_writer.release();
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		if (!m_open)
+			return;
+
+		// no new frame is accepted, and the blocked addFrame calls return.
+		m_open = false;
+		m_stop = true;
+	}
+	m_cond.notify_all();
+	m_space.notify_all();
+
+	// the encoder thread writes the queued frames before it exits.
+	if (m_thread.joinable())
+		m_thread.join();
+	if (m_opener.joinable())
+		m_opener.join();
+
+	m_writer->release();
+	closed(m_segment);
+
+	// the next segment was opened in advance, but it has no frame.
+	if (m_next)
+	{
+		const auto file = segmentFile(m_segment.index + 1);
+		m_next->release();
+		m_next.reset();
+		std::remove(file.c_str());
+	}
+}
+
+auto fvkVideoWriter::isSegmented() const -> bool
+{
+	return m_segmentduration > 0 || m_segmentsize > 0;
+}
+
+auto fvkVideoWriter::segmentFile(int _index) const -> std::string
+{
+	char number[16];
+	std::snprintf(number, sizeof(number), "_%04d", _index);
+
+	// the number goes before the extension of the file name, not of a folder.
+	const auto slash = m_file.find_last_of("/\\");
+	const auto dot = m_file.find_last_of('.');
+	if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+		return m_file + number;
+	return m_file.substr(0, dot) + number + m_file.substr(dot);
+}
+
+auto fvkVideoWriter::openFile(const std::string& _file) const -> std::unique_ptr<cv::VideoWriter>
+{
+	std::unique_ptr<cv::VideoWriter> w(new cv::VideoWriter());
+	w->set(cv::VideoWriterProperties::VIDEOWRITER_PROP_QUALITY, 100.0);
+	w->open(_file, m_api, m_fourcc, m_fps, m_size, m_iscolor);
+	if (!w->isOpened())
+		return nullptr;
+	return w;
+}
+
+void fvkVideoWriter::closed(fvkVideoSegment& _segment)
+{
+	_segment.duration = m_fps > 0 ? static_cast<double>(_segment.frames) / m_fps : 0;
+	_segment.bytes = __fileSize(_segment.file);
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_stats.segments++;
+	}
+	if (m_segment_func)
+		m_segment_func(_segment);
+}
+
+void fvkVideoWriter::rotate()
+{
+	// the next segment is normally opened long ago, so this does not wait.
+	if (m_opener.joinable())
+		m_opener.join();
+	if (!m_next)
+	{
+		std::cout << "could not open the video segment " << segmentFile(m_segment.index + 1) << ", the recording continues in " << m_segment.file << "\n";
+		m_rotate = false;
+		return;
+	}
+
+	std::shared_ptr<cv::VideoWriter> old(std::move(m_writer));
+	m_writer = std::move(m_next);
+	auto done = m_segment;
+	m_segment = fvkVideoSegment();
+	m_segment.index = done.index + 1;
+	m_segment.file = segmentFile(m_segment.index);
+
+	// closing a file flushes the encoder, so it is done in the background with the opening of the next one.
+	const auto file = segmentFile(m_segment.index + 1);
+	m_opener = std::thread([this, old, done, file]() mutable
+	{
+		old->release();
+		closed(done);
+		m_next = openFile(file);
+	});
 }
 
 void fvkVideoWriter::addFrame(const cv::Mat& _frame)
@@ -78,5 +237,126 @@ void fvkVideoWriter::addFrame(const cv::Mat& _frame)
 	if (_frame.empty() || _frame.size() != m_size) 
 		return;
 
-	m_writer.write(_frame);
-}
\ No newline at end of file
+	const auto bytes = __bytes(_frame);
+	{
+		std::unique_lock<std::mutex> lk(m_mutex);
+		if (!m_open)
+			return;
+
+		m_stats.frames++;
+		if (m_policy == BacklogPolicy::Block)
+		{
+			if (m_stats.backlog >= m_maxbacklog)
+			{
+				const auto t = cv::getTickCount();
+				m_space.wait(lk, [this]() { return m_stats.backlog < m_maxbacklog || !m_open; });
+				m_stats.blocked_time += static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency();
+				if (!m_open)
+					return;
+			}
+		}
+		else if (m_policy == BacklogPolicy::Drop ? m_stats.backlog >= m_maxbacklog : m_stats.memory + bytes > m_maxmemory && m_stats.backlog > 0)
+		{
+			m_stats.dropped++;
+			return;
+		}
+
+		m_queue.push_back(_frame);
+		m_stats.backlog++;
+		m_stats.memory += bytes;
+		m_stats.peak_backlog = std::max(m_stats.peak_backlog, m_stats.backlog);
+	}
+	m_cond.notify_one();
+}
+
+void fvkVideoWriter::run()
+{
+	std::deque<cv::Mat> frames;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lk(m_mutex);
+			m_cond.wait(lk, [this]() { return !m_queue.empty() || m_stop; });
+			if (m_queue.empty())
+				return;
+
+			// the queue is swapped with an empty one, so addFrame fills one while the other is encoded.
+			frames.swap(m_queue);
+		}
+
+		while (!frames.empty())
+		{
+			if (m_rotate && isSegmented() && m_segment.frames > 0)
+			{
+				if (m_segmentsize > 0 && m_segment.frames % SIZE_CHECK_FRAMES == 0)
+					m_segment.bytes = __fileSize(m_segment.file);
+				if ((m_segmentduration > 0 && m_segment.frames >= static_cast<long long>(m_segmentduration * m_fps + 0.5)) ||
+					(m_segmentsize > 0 && m_segment.bytes >= m_segmentsize))
+					rotate();
+			}
+
+			const auto t = cv::getTickCount();
+			m_writer->write(frames.front());
+			m_segment.frames++;
+			const auto ms = static_cast<double>(cv::getTickCount() - t) * 1000.0 / cv::getTickFrequency();
+			const auto bytes = __bytes(frames.front());
+			frames.pop_front();
+
+			{
+				std::lock_guard<std::mutex> locker(m_mutex);
+				m_stats.written++;
+				m_stats.backlog--;
+				m_stats.memory -= bytes;
+				m_totalencode += ms;
+				m_stats.encode_time = m_totalencode / static_cast<double>(m_stats.written);
+				m_stats.max_encode_time = std::max(m_stats.max_encode_time, ms);
+			}
+			m_space.notify_all();
+		}
+	}
+}
+
+void fvkVideoWriter::setBacklogPolicy(BacklogPolicy _policy)
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_policy = _policy;
+	}
+	m_space.notify_all();
+}
+auto fvkVideoWriter::getBacklogPolicy() const -> BacklogPolicy
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_policy;
+}
+
+void fvkVideoWriter::setMaxBacklog(int _frames)
+{
+	{
+		std::lock_guard<std::mutex> locker(m_mutex);
+		m_maxbacklog = std::max(_frames, 1);
+	}
+	m_space.notify_all();
+}
+auto fvkVideoWriter::getMaxBacklog() const -> int
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_maxbacklog;
+}
+
+void fvkVideoWriter::setMaxBacklogMemory(std::size_t _bytes)
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	m_maxmemory = _bytes;
+}
+auto fvkVideoWriter::getMaxBacklogMemory() const -> std::size_t
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_maxmemory;
+}
+
+auto fvkVideoWriter::getStats() const -> fvkVideoWriterStats
+{
+	std::lock_guard<std::mutex> locker(m_mutex);
+	return m_stats;
+}